@@ -10,19 +10,44 @@
  *
  *      Balancing is performed at each insertion to the tree to keep the depth
  *      of the tree at a minimum with the intention of preserving the
- *      `O(log n)` search complexity.
+ *      `O(log n)` search complexity. Each node keeps the height of its
+ *      subtree, so only the nodes along the path of an insertion need to be
+ *      looked at again.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
 
 #include "t_typedef.h"
 #include "e_malloc.h"
 #include "a_avl.h"
 
-static AVL_Node* AVL_InitNode (int data)
+// the alignment of the keys of a frozen tree
+#define AVL_CACHELINE 64
+
+/* `AVL_PushBatch` splits the tree into at most as many parts */
+#define AVL_MAXPARTS 64
+#define AVL_MAXTHREADS 16
+
+// whether the sizes of the subtrees have to be kept up to date all the way up
+#ifdef AVL_SIZES
+#define AVL_TRACKING(p_tree) ((p_tree)->tracking)
+#else
+#define AVL_TRACKING(p_tree) 0
+#endif
+
+static AVL_Node* AVL_InitNode (AVL_Tree* p_tree, int data)
 {
-    AVL_Node* p_node = (AVL_Node*) E_Malloc(sizeof(AVL_Node), AVL_InitNode);
+    AVL_Node* p_node;
+    if (p_tree->p_slab) p_node = (AVL_Node*) E_SlabAlloc(p_tree->p_slab);
+    else p_node = (AVL_Node*) E_Malloc(sizeof(AVL_Node), AVL_InitNode);
     p_node->data = data;
+    p_node->height = 1;
+#ifdef AVL_SIZES
+    p_node->size = 1;
+#endif
     p_node->p_left = NULL;
     p_node->p_right = NULL;
     return p_node;
@@ -41,143 +66,763 @@ static void AVL_PrintNode (AVL_Node* p_node)
     printf("\n");
 }
 
-static void AVL_PrintPreOrder (AVL_Node* p_root)
+static void AVL_PrintPreOrder (AVL_Tree* p_tree)
+{
+    AVL_Iter iter;
+    for (AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, AVL_PREORDER);
+         p_node; p_node = AVL_IterNext(&iter))
+        AVL_PrintNode(p_node);
+}
+
+static int AVL_Height (AVL_Node* p_node)
+{
+    return p_node ? p_node->height : 0;
+}
+
+#ifdef AVL_SIZES
+static int AVL_Size (AVL_Node* p_node)
+{
+    return p_node ? p_node->size : 0;
+}
+#endif
+
+/* brings the height and the size of the subtree at `p_node` up to date */
+static void AVL_Update (AVL_Node* p_node)
+{
+    int heightleft = AVL_Height(p_node->p_left);
+    int heightright = AVL_Height(p_node->p_right);
+    p_node->height = (heightleft >= heightright ? heightleft : heightright) + 1;
+#ifdef AVL_SIZES
+    p_node->size = AVL_Size(p_node->p_left) + AVL_Size(p_node->p_right) + 1;
+#endif
+}
+
+static AVL_Node* AVL_RotateLeft (AVL_Node* p_node)
+{
+    AVL_Node* p_newroot = p_node->p_right;
+    p_node->p_right = p_newroot->p_left;
+    p_newroot->p_left = p_node;
+    AVL_Update(p_node);
+    AVL_Update(p_newroot);
+    return p_newroot;
+}
+
+static AVL_Node* AVL_RotateRight (AVL_Node* p_node)
+{
+    AVL_Node* p_newroot = p_node->p_left;
+    p_node->p_left = p_newroot->p_right;
+    p_newroot->p_right = p_node;
+    AVL_Update(p_node);
+    AVL_Update(p_newroot);
+    return p_newroot;
+}
+
+/* brings the height of the subtree at `p_node` up to date, and rotates it if
+ * its children differ in height by more than 1, returning its new root
+ */
+static AVL_Node* AVL_Balance (AVL_Node* p_node)
+{
+    int balancefactor = AVL_Height(p_node->p_left) -
+                        AVL_Height(p_node->p_right);
+    /* unbalanced due to the right subtree */
+    if (balancefactor < -1)
+    {
+        // the right child leans to the left, so a double rotation is needed
+        if (AVL_Height(p_node->p_right->p_left) >
+            AVL_Height(p_node->p_right->p_right))
+            p_node->p_right = AVL_RotateRight(p_node->p_right);
+        return AVL_RotateLeft(p_node);
+    }
+    /* unbalanced due to the left subtree */
+    if (balancefactor > 1)
+    {
+        // the left child leans to the right, so a double rotation is needed
+        if (AVL_Height(p_node->p_left->p_right) >
+            AVL_Height(p_node->p_left->p_left))
+            p_node->p_left = AVL_RotateLeft(p_node->p_left);
+        return AVL_RotateRight(p_node);
+    }
+    AVL_Update(p_node);
+    return p_node;
+}
+
+static void AVL_FreeNode (AVL_Tree* p_tree, AVL_Node* p_node)
+{
+    // the nodes laid out by `AVL_BuildSorted` go away along with the tree
+    if (p_node >= p_tree->p_bulk && p_node < p_tree->p_bulk + p_tree->numbulk)
+        return;
+    if (p_tree->p_slab) E_SlabFree(p_tree->p_slab, p_node);
+    else E_Free(p_node);
+}
+
+AVL_Tree* AVL_InitTree (void)
+{
+    AVL_Tree* p_tree = (AVL_Tree*) E_Malloc(sizeof(AVL_Tree), AVL_InitTree);
+    p_tree->p_root = NULL;
+    p_tree->p_slab = NULL;
+    p_tree->p_bulk = NULL;
+    p_tree->numbulk = 0;
+#ifdef AVL_SIZES
+    p_tree->tracking = 0;
+#endif
+    return p_tree;
+}
+
+/* builds the subtree of the keys in `[lo, hi)` out of the nodes at the same
+ * indices, and returns its root
+ */
+static AVL_Node* AVL_BuildSorted_ (AVL_Node* nodes, int* keys, size_t lo,
+                                   size_t hi)
 {
-    AVL_PrintNode(p_root);
-    if (p_root->p_left) AVL_PrintPreOrder(p_root->p_left);
-    if (p_root->p_right) AVL_PrintPreOrder(p_root->p_right);
+    if (lo == hi) return NULL;
+    size_t mid = lo + ((hi - lo) >> 1);
+    AVL_Node* p_node = nodes + mid;
+    p_node->data = keys[mid];
+    p_node->p_left = AVL_BuildSorted_(nodes, keys, lo, mid);
+    p_node->p_right = AVL_BuildSorted_(nodes, keys, mid + 1, hi);
+    AVL_Update(p_node);
+    return p_node;
+}
+
+/* builds a perfectly balanced tree out of `n` keys sorted in ascending order
+ * in `O(n)`, with all of its nodes laid out in a single block in the same
+ * order as the keys
+ */
+AVL_Tree* AVL_BuildSorted (int* keys, size_t n)
+{
+    for (size_t i = 1; i < n; ++i)
+    {
+        if (keys[i - 1] <= keys[i]) continue;
+        printf("AVL_BuildSorted: Keys are not sorted.\n");
+        return NULL;
+    }
+    AVL_Tree* p_tree = AVL_InitTree();
+    if (!n) return p_tree;
+    AVL_Node* nodes = (AVL_Node*) E_Malloc(sizeof(AVL_Node) * n,
+                                           AVL_BuildSorted);
+    if (!nodes)
+    {
+        E_Free(p_tree);
+        return NULL;
+    }
+    p_tree->p_bulk = nodes;
+    p_tree->numbulk = n;
+    p_tree->p_root = AVL_BuildSorted_(nodes, keys, 0, n);
+    return p_tree;
 }
 
-static void AVL_Push_ (AVL_Node* p_root, AVL_Node* p_node)
+/* allocates the nodes of the tree from `p_slab` from now on, which may be
+ * shared with other trees; can only be changed while the tree is empty
+ */
+void AVL_UseSlab (AVL_Tree* p_tree, E_Slab* p_slab)
 {
-    if (p_root->data >= p_node->data)
+    if (!AVL_IsEmpty(*p_tree))
     {
-        if (p_root->p_left == NULL) p_root->p_left = p_node;
-        else AVL_Push_(p_root->p_left, p_node);
+        printf("AVL_UseSlab: Tree is not empty.\n");
+        return;
     }
-    else if (p_root->data < p_node->data)
+    if (p_slab && E_SlabObjSize(p_slab) < sizeof(AVL_Node))
     {
-        if (p_root->p_right == NULL) p_root->p_right = p_node;
-        else AVL_Push_(p_root->p_right, p_node);
+        printf("AVL_UseSlab: Slab objects too small.\n");
+        return;
     }
+    p_tree->p_slab = p_slab;
+}
+
+#ifdef AVL_SIZES
+/* keeps the size of every subtree up to date from now on, at the cost of
+ * walking every insertion and removal up to the root, for `AVL_Select` and
+ * `AVL_Rank`–the sizes are counted from scratch in `O(n)` once enabled
+ */
+void AVL_TrackSizes (AVL_Tree* p_tree, int enabled)
+{
+    if (enabled && !p_tree->tracking)
+    {
+        // in post-order, the children of a node are counted before it
+        AVL_Iter iter;
+        for (AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, AVL_POSTORDER);
+             p_node; p_node = AVL_IterNext(&iter))
+            p_node->size = AVL_Size(p_node->p_left) +
+                           AVL_Size(p_node->p_right) + 1;
+    }
+    p_tree->tracking = enabled;
+}
+#endif
+
+int AVL_IsEmpty (AVL_Tree tree)
+{
+    return tree.p_root == NULL;
 }
 
-static int AVL_Balance_ (AVL_Node* p_node, AVL_Node* p_parent, AVL_Tree* p_tree)
+/* inserts a node into the subtree at `p_root` in `O(log n)`, rebalancing
+ * only the subtrees along the way down to it
+ */
+static void AVL_PushNode (AVL_Tree* p_tree, AVL_Node** p_root,
+                          AVL_Node* p_node)
 {
-    // base case: if a leaf node, the subtree is balanced by default, return
-    // a depth value of 1
-    if (p_node->p_left == NULL && p_node->p_right == NULL) return 1;
-    /* recursively call the same routine for left and right children */
-    int depthleft = 0, depthright = 0;
-    if (p_node->p_left)
-        depthleft = AVL_Balance_(p_node->p_left, p_node, p_tree);
-    if (p_node->p_right)
-        depthright = AVL_Balance_(p_node->p_right, p_node, p_tree);
-    /* calculate the balancing factor for the current subtree, and perform
-     * rotations based on the orientation of the subtree if needed
+    // the links followed on the way down, to walk back up along
+    AVL_Node** path[AVL_MAXHEIGHT];
+    int depth = 0;
+    AVL_Node** p_link = p_root;
+    int data = p_node->data;
+    while (*p_link)
+    {
+        path[depth++] = p_link;
+        if (data <= (*p_link)->data) p_link = &(*p_link)->p_left;
+        else p_link = &(*p_link)->p_right;
+    }
+    *p_link = p_node;
+    /* rebalance on the way back up, until a subtree turns out to be as high
+     * as it was before, as then none of the ones above it can have changed–
+     * unless the sizes are tracked, which change all the way up
      */
-    int balancefactor = depthleft - depthright;
-    /* unbalanced due to the right subtree */
-    if (balancefactor < -1)
+    while (depth--)
+    {
+        AVL_Node* p_node = *path[depth];
+        int height = p_node->height;
+        *path[depth] = AVL_Balance(p_node);
+        if ((*path[depth])->height == height && !AVL_TRACKING(p_tree))
+            break;
+    }
+}
+
+void AVL_Push (AVL_Tree* p_tree, int data)
+{
+    AVL_PushNode(p_tree, &p_tree->p_root, AVL_InitNode(p_tree, data));
+}
+
+/* joins two trees, with every key in `p_left` not greater than the key of
+ * `p_pivot` and every key in `p_right` not less than it, into one, in
+ * `O(|height(p_left) - height(p_right)|)`–the pivot is hung down the spine of
+ * the taller tree where the heights meet, and the spine is rebalanced on the
+ * way back up
+ */
+static AVL_Node* AVL_Join (AVL_Node* p_left, AVL_Node* p_pivot,
+                           AVL_Node* p_right)
+{
+    int heightleft = AVL_Height(p_left), heightright = AVL_Height(p_right);
+    AVL_Node** path[AVL_MAXHEIGHT];
+    int depth = 0;
+    AVL_Node* p_root = heightleft > heightright ? p_left : p_right;
+    AVL_Node** p_link = &p_root;
+    if (heightleft > heightright + 1)
     {
-        /* balance subtree (double rotation) */
-        if (p_node->p_right->p_left != NULL)
+        while (AVL_Height(*p_link) > heightright + 1)
         {
-            AVL_Node* p_newintroot = p_node->p_right->p_left;
-            p_node->p_right->p_left = p_newintroot->p_right;
-            p_newintroot->p_right = p_node->p_right;
-            p_node->p_right = p_newintroot;
+            path[depth++] = p_link;
+            p_link = &(*p_link)->p_right;
         }
-        /* balance subtree (single rotation) */
-        AVL_Node* p_newroot = p_node->p_right;
-        p_node->p_right = p_newroot->p_left;
-        p_newroot->p_left = p_node;
-        /* update parent/root */
-        // if parent is NULL, it means we are at the absolute root of the tree
-        if (p_parent == NULL) p_tree->p_root = p_newroot;
-        else if (p_parent->p_left == p_node) p_parent->p_left = p_newroot;
-        else if (p_parent->p_right == p_node) p_parent->p_right = p_newroot;
-        return depthright; // return the depth after balancing
+        p_left = *p_link;
     }
-    /* unbalanced due to the left subtree */
-    else if (balancefactor > 1)
+    else if (heightright > heightleft + 1)
     {
-        /* balance subtree (double rotation) */
-        if (p_node->p_left->p_right != NULL)
+        while (AVL_Height(*p_link) > heightleft + 1)
         {
-            AVL_Node* p_newintroot = p_node->p_left->p_right;
-            p_node->p_left->p_right = p_newintroot->p_left;
-            p_newintroot->p_left = p_node->p_left;
-            p_node->p_left = p_newintroot;
+            path[depth++] = p_link;
+            p_link = &(*p_link)->p_left;
         }
-        /* balance subtree (single rotation) */
-        AVL_Node* p_newroot = p_node->p_left;
-        p_node->p_left = p_newroot->p_right;
-        p_newroot->p_right = p_node;
-        /* update parent/root */
-        // if parent is NULL, it means we are at the absolute root of the tree
-        if (p_parent == NULL) p_tree->p_root = p_newroot;
-        else if (p_parent->p_left == p_node) p_parent->p_left = p_newroot;
-        else if (p_parent->p_right == p_node) p_parent->p_right = p_newroot;
-        return depthleft; // return the depth after balancing
+        p_right = *p_link;
     }
-    return (depthleft >= depthright ? depthleft : depthright) + 1;
+    p_pivot->p_left = p_left;
+    p_pivot->p_right = p_right;
+    AVL_Update(p_pivot);
+    *p_link = p_pivot;
+    while (depth--) *path[depth] = AVL_Balance(*path[depth]);
+    return p_root;
 }
 
-static void AVL_Balance (AVL_Tree* p_tree)
+AVL_Node* AVL_Find (AVL_Tree* p_tree, int data)
 {
-    AVL_Balance_(p_tree->p_root, NULL, p_tree);
+    AVL_Node* p_node = p_tree->p_root;
+    while (p_node && p_node->data != data)
+        p_node = data < p_node->data ? p_node->p_left : p_node->p_right;
+    return p_node;
 }
 
-static int AVL_Depth_ (AVL_Node* p_root)
+/* removes a single node holding `data` in `O(log n)`, returning 1 if there
+ * was one, and 0 otherwise
+ */
+int AVL_Remove (AVL_Tree* p_tree, int data)
 {
-    if (p_root == NULL) return 0;
-    int depthleft = AVL_Depth_(p_root->p_left);
-    int depthright = AVL_Depth_(p_root->p_right);
-    int maxdepth = depthleft >= depthright ? depthleft : depthright;
-    return maxdepth + 1;
+    AVL_Node** path[AVL_MAXHEIGHT];
+    int depth = 0;
+    AVL_Node** p_link = &p_tree->p_root;
+    while (*p_link && (*p_link)->data != data)
+    {
+        path[depth++] = p_link;
+        if (data < (*p_link)->data) p_link = &(*p_link)->p_left;
+        else p_link = &(*p_link)->p_right;
+    }
+    AVL_Node* p_node = *p_link;
+    if (!p_node) return 0;
+    if (!p_node->p_left || !p_node->p_right)
+        *p_link = p_node->p_left ? p_node->p_left : p_node->p_right;
+    else
+    {
+        /* unlink the successor, i.e., the leftmost node of the right subtree,
+         * and put it in place of the node
+         */
+        int nodedepth = depth;
+        path[depth++] = p_link;
+        AVL_Node** p_succlink = &p_node->p_right;
+        while ((*p_succlink)->p_left)
+        {
+            path[depth++] = p_succlink;
+            p_succlink = &(*p_succlink)->p_left;
+        }
+        AVL_Node* p_succ = *p_succlink;
+        *p_succlink = p_succ->p_right;
+        p_succ->p_left = p_node->p_left;
+        p_succ->p_right = p_node->p_right;
+        p_succ->height = p_node->height;
+        *p_link = p_succ;
+        // the link to the right subtree has moved along with the successor
+        if (depth > nodedepth + 1) path[nodedepth + 1] = &p_succ->p_right;
+    }
+    AVL_FreeNode(p_tree, p_node);
+    /* rebalance on the way back up, until a subtree turns out to be as high
+     * as it was before, unless the sizes are tracked
+     */
+    while (depth--)
+    {
+        AVL_Node* p_parent = *path[depth];
+        int height = p_parent->height;
+        *path[depth] = AVL_Balance(p_parent);
+        if ((*path[depth])->height == height && !AVL_TRACKING(p_tree))
+            break;
+    }
+    return 1;
 }
 
-static void AVL_Destroy_ (AVL_Node* p_node)
+/* the leftmost node not less than `data`, or NULL if there's none */
+AVL_Node* AVL_LowerBound (AVL_Tree* p_tree, int data)
 {
-    E_Free(p_node);// destroy this node
-    /* destroy left and right subtrees recursively */
-    AVL_Node* p_left = p_node->p_left;
-    AVL_Node* p_right = p_node->p_right;
-    if (p_left) AVL_Destroy_(p_left);
-    if (p_right) AVL_Destroy_(p_right);
+    AVL_Node *p_node = p_tree->p_root, *p_bound = NULL;
+    while (p_node)
+    {
+        if (p_node->data >= data) { p_bound = p_node; p_node = p_node->p_left; }
+        else p_node = p_node->p_right;
+    }
+    return p_bound;
 }
 
-AVL_Tree* AVL_InitTree (void)
+/* the leftmost node greater than `data`, or NULL if there's none */
+AVL_Node* AVL_UpperBound (AVL_Tree* p_tree, int data)
 {
-    AVL_Tree* p_tree = (AVL_Tree*) E_Malloc(sizeof(AVL_Tree), AVL_InitTree);
-    p_tree->p_root = NULL;
-    return p_tree;
+    AVL_Node *p_node = p_tree->p_root, *p_bound = NULL;
+    while (p_node)
+    {
+        if (p_node->data > data) { p_bound = p_node; p_node = p_node->p_left; }
+        else p_node = p_node->p_right;
+    }
+    return p_bound;
 }
 
-int AVL_IsEmpty (AVL_Tree tree)
+/* calls `visit` on every node in `[lo, hi)` in order, in `O(log n + k)`,
+ * and returns the number of nodes visited–`visit` may be NULL to only count
+ * them
+ */
+size_t AVL_VisitRange (AVL_Tree* p_tree, int lo, int hi, AVL_Visitor visit,
+                       void* p_context)
 {
-    return tree.p_root == NULL;
+    // the nodes whose left subtree is being walked, i.e., yet to be visited
+    AVL_Node* stack[AVL_MAXHEIGHT];
+    int depth = 0;
+    size_t numvisited = 0;
+    AVL_Node* p_node = p_tree->p_root;
+    for (;;)
+    {
+        /* go as far left as the range allows, skipping the subtrees to the
+         * left of `lo` altogether
+         */
+        while (p_node)
+        {
+            if (p_node->data >= lo)
+            {
+                stack[depth++] = p_node;
+                p_node = p_node->p_left;
+            }
+            else p_node = p_node->p_right;
+        }
+        if (!depth) break;
+        p_node = stack[--depth];
+        if (p_node->data >= hi) break;
+        if (visit) visit(p_node, p_context);
+        ++numvisited;
+        p_node = p_node->p_right;
+    }
+    return numvisited;
 }
 
-void AVL_Push (AVL_Tree* p_tree, int data)
+/* the index in an Eytzinger layout of `numkeys` keys that follows `k` in
+ * order–i.e., the leftmost one in the right subtree of `k` if there's one,
+ * and otherwise the first ancestor `k` is to the left of
+ */
+static size_t AVL_EytzingerNext (size_t k, size_t numkeys)
+{
+    if ((k << 1 | 1) <= numkeys)
+    {
+        k = k << 1 | 1;
+        while (k << 1 <= numkeys) k <<= 1;
+        return k;
+    }
+    while (k & 1) k >>= 1;
+    return k >> 1;
+}
+
+/* lays the keys of the tree out in an array in the Eytzinger order, i.e., in
+ * the breadth-first order of a complete binary tree, where the children of
+ * the key at `k` are at `2k` and `2k + 1`–the first levels, visited by every
+ * lookup, share a handful of cache lines, and the ones below can be fetched
+ * ahead of time, as they sit right next to each other
+ */
+AVL_Frozen* AVL_Freeze (AVL_Tree* p_tree)
+{
+    AVL_Iter iter;
+    AVL_Node* p_node;
+    /* count the keys first */
+    size_t numkeys = 0;
+    for (p_node = AVL_IterBegin(&iter, p_tree, AVL_PREORDER); p_node;
+         p_node = AVL_IterNext(&iter))
+        ++numkeys;
+    AVL_Frozen* p_frozen = (AVL_Frozen*) E_Malloc(sizeof(AVL_Frozen),
+                                                  AVL_Freeze);
+    // index 0 is left unused, so that the search can tell it apart
+    p_frozen->keys = (int*) E_MallocAligned(sizeof(int) * (numkeys + 1),
+                                            AVL_CACHELINE, AVL_Freeze);
+    p_frozen->numkeys = numkeys;
+    p_frozen->keys[0] = INT_MIN;
+    /* walk the tree and the layout in order side by side */
+    size_t k = 1;
+    while (k << 1 <= numkeys) k <<= 1;
+    for (p_node = AVL_IterBegin(&iter, p_tree, AVL_INORDER); p_node;
+         p_node = AVL_IterNext(&iter))
+    {
+        p_frozen->keys[k] = p_node->data;
+        k = AVL_EytzingerNext(k, numkeys);
+    }
+    return p_frozen;
+}
+
+/* the smallest key not less than `data`, or NULL if there's none, without a
+ * single branch in the loop but its condition
+ */
+const int* AVL_FrozenLowerBound (AVL_Frozen* p_frozen, int data)
+{
+    const int* keys = p_frozen->keys;
+    size_t k = 1;
+    while (k <= p_frozen->numkeys)
+    {
+        // the 16 descendants 4 levels down share a single cache line
+        __builtin_prefetch(keys + (k << 4));
+        k = k << 1 | (keys[k] < data);
+    }
+    /* the search went right past every key less than `data` from the last
+     * time it went left, i.e., from the key it is looking for, so undo the
+     * trailing right turns, and the left turn before them
+     */
+    k >>= __builtin_ctzl(~k) + 1;
+    return k ? keys + k : NULL;
+}
+
+int AVL_FrozenContains (AVL_Frozen* p_frozen, int data)
+{
+    const int* p_key = AVL_FrozenLowerBound(p_frozen, data);
+    return p_key && *p_key == data;
+}
+
+void AVL_FrozenDestroy (AVL_Frozen* p_frozen)
+{
+    if (!p_frozen) return;
+    E_Free(p_frozen->keys);
+    E_Free(p_frozen);
+}
+
+#ifdef AVL_SIZES
+/* the node holding the `k`th smallest key, counting from 0, or NULL if
+ * there are not as many nodes
+ */
+AVL_Node* AVL_Select (AVL_Tree* p_tree, size_t k)
+{
+    if (!p_tree->tracking)
+    {
+        printf("AVL_Select: Tree does not track sizes.\n");
+        return NULL;
+    }
+    AVL_Node* p_node = p_tree->p_root;
+    while (p_node)
+    {
+        size_t sizeleft = AVL_Size(p_node->p_left);
+        if (k == sizeleft) break;
+        if (k < sizeleft) p_node = p_node->p_left;
+        else
+        {
+            k -= sizeleft + 1;
+            p_node = p_node->p_right;
+        }
+    }
+    return p_node;
+}
+
+/* the number of keys less than `data` */
+size_t AVL_Rank (AVL_Tree* p_tree, int data)
 {
-    AVL_Node* p_node = AVL_InitNode(data);
-    if (AVL_IsEmpty(*p_tree)) p_tree->p_root = p_node;
-    else AVL_Push_(p_tree->p_root, p_node);
-    AVL_Balance(p_tree);
+    if (!p_tree->tracking)
+    {
+        printf("AVL_Rank: Tree does not track sizes.\n");
+        return 0;
+    }
+    size_t rank = 0;
+    AVL_Node* p_node = p_tree->p_root;
+    while (p_node)
+    {
+        if (data <= p_node->data) p_node = p_node->p_left;
+        else
+        {
+            rank += AVL_Size(p_node->p_left) + 1;
+            p_node = p_node->p_right;
+        }
+    }
+    return rank;
+}
+#endif
+
+/* splits the tree into the subtrees `numlevels` levels down, in order, and
+ * the nodes above them, each of which falls in between two of the subtrees
+ */
+static void AVL_Split (AVL_Node* p_node, int numlevels, AVL_Node** parts,
+                       AVL_Node** pivots, int* p_numparts)
+{
+    if (!p_node || !numlevels)
+    {
+        parts[(*p_numparts)++] = p_node;
+        return;
+    }
+    AVL_Split(p_node->p_left, numlevels - 1, parts, pivots, p_numparts);
+    pivots[*p_numparts - 1] = p_node;
+    AVL_Split(p_node->p_right, numlevels - 1, parts, pivots, p_numparts);
+}
+
+typedef struct {
+    AVL_Tree* p_tree;
+    AVL_Node* parts[AVL_MAXPARTS];
+    AVL_Node** nodes; // the nodes to push, sorted by their keys
+    size_t starts[AVL_MAXPARTS]; // where the nodes of each part start
+    size_t ends[AVL_MAXPARTS]; // ...and where they end
+    int numparts;
+    int nextpart; // the next part to be picked up by a worker
+} AVL_Batch;
+
+/* pushes the nodes of a part after another into its own subtree, until no
+ * part is left
+ */
+static void* AVL_BatchWorker (void* p_batch_)
+{
+    AVL_Batch* p_batch = (AVL_Batch*) p_batch_;
+    int part;
+    while ((part = __atomic_fetch_add(&p_batch->nextpart, 1,
+                                      __ATOMIC_RELAXED)) < p_batch->numparts)
+    {
+        for (size_t i = p_batch->starts[part]; i < p_batch->ends[part]; ++i)
+            AVL_PushNode(p_batch->p_tree, p_batch->parts + part,
+                         p_batch->nodes[i]);
+    }
+    return NULL;
+}
+
+/* links the nodes sorted by their keys between `lo` and `hi` into a
+ * perfectly balanced subtree, the same way as `AVL_BuildSorted_`
+ */
+static AVL_Node* AVL_BuildNodes_ (AVL_Node** nodes, size_t lo, size_t hi)
+{
+    if (lo >= hi) return NULL;
+    size_t mid = lo + ((hi - lo) >> 1);
+    AVL_Node* p_node = nodes[mid];
+    p_node->p_left = AVL_BuildNodes_(nodes, lo, mid);
+    p_node->p_right = AVL_BuildNodes_(nodes, mid + 1, hi);
+    AVL_Update(p_node);
+    return p_node;
+}
+
+/* builds the subtree of a part after another out of its nodes, until no part
+ * is left
+ */
+static void* AVL_BuildWorker (void* p_batch_)
+{
+    AVL_Batch* p_batch = (AVL_Batch*) p_batch_;
+    int part;
+    while ((part = __atomic_fetch_add(&p_batch->nextpart, 1,
+                                      __ATOMIC_RELAXED)) < p_batch->numparts)
+        p_batch->parts[part] = AVL_BuildNodes_(p_batch->nodes,
+                                               p_batch->starts[part],
+                                               p_batch->ends[part]);
+    return NULL;
+}
+
+/* runs `worker` over the parts of the batch on up to `numthreads` threads–
+ * the calling thread does its share as well, and picks up whatever the
+ * threads that could not be created would have
+ */
+static void AVL_RunBatch (AVL_Batch* p_batch, void* (*worker) (void*),
+                          int numthreads)
+{
+    pthread_t threads[AVL_MAXTHREADS];
+    int numcreated = 0;
+    p_batch->nextpart = 0;
+    while (numcreated < numthreads - 1 &&
+           !pthread_create(threads + numcreated, NULL, worker, p_batch))
+        ++numcreated;
+    worker(p_batch);
+    for (int t = 0; t < numcreated; ++t) pthread_join(threads[t], NULL);
+}
+
+/* builds a tree out of the `n` nodes sorted by their keys, which are cut into
+ * `AVL_MAXTHREADS` runs, each built into a subtree of its own in parallel,
+ * and joined back together around the nodes in between the runs
+ */
+static AVL_Node* AVL_BuildBatch (AVL_Batch* p_batch, AVL_Node** nodes,
+                                 size_t n, int numthreads)
+{
+    int numparts = n < AVL_MAXTHREADS ? (int) n : AVL_MAXTHREADS;
+    if (!numparts) return NULL;
+    p_batch->nodes = nodes;
+    p_batch->numparts = numparts;
+    for (int part = 0; part < numparts; ++part)
+    {
+        // every run but the first starts past the node it's joined at
+        p_batch->starts[part] = n * part / numparts + !!part;
+        p_batch->ends[part] = n * (part + 1) / numparts;
+    }
+    AVL_RunBatch(p_batch, AVL_BuildWorker, numthreads);
+    AVL_Node* p_root = p_batch->parts[0];
+    for (int part = 1; part < numparts; ++part)
+        p_root = AVL_Join(p_root, nodes[p_batch->starts[part] - 1],
+                          p_batch->parts[part]);
+    return p_root;
+}
+
+/* merges the nodes of the tree with the `n` nodes sorted by their keys,
+ * returning a new array of them all, sorted as well, along with how many
+ * there are
+ */
+static AVL_Node** AVL_MergeNodes (AVL_Tree* p_tree, AVL_Node** nodes,
+                                  size_t n, size_t* p_nummerged)
+{
+    size_t numnodes = 0;
+    AVL_Iter iter;
+    for (AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, AVL_INORDER);
+         p_node; p_node = AVL_IterNext(&iter))
+        ++numnodes;
+    AVL_Node** merged = (AVL_Node**) E_Malloc(sizeof(AVL_Node*) *
+                                              (numnodes + n), AVL_MergeNodes);
+    size_t i = 0, nummerged = 0;
+    for (AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, AVL_INORDER);
+         p_node; p_node = AVL_IterNext(&iter))
+    {
+        while (i < n && nodes[i]->data < p_node->data)
+            merged[nummerged++] = nodes[i++];
+        merged[nummerged++] = p_node;
+    }
+    while (i < n) merged[nummerged++] = nodes[i++];
+    *p_nummerged = nummerged;
+    return merged;
+}
+
+static int AVL_CompareInts (const void* p_a, const void* p_b)
+{
+    int a = *((const int*) p_a), b = *((const int*) p_b);
+    return (a > b) - (a < b);
+}
+
+/* pushes `n` keys at once on up to `numthreads` threads: the keys are sorted
+ * and split at the keys of the top few levels of the tree, so that each part
+ * goes into a subtree of its own, in parallel, and the subtrees are joined
+ * back together at the end, around the nodes they were split at
+ *
+ * a tree too small to fill those levels, e.g., an empty one, would leave
+ * most of the threads without a part, so it's rather merged with the keys
+ * and built anew, see `AVL_BuildBatch`
+ */
+void AVL_PushBatch (AVL_Tree* p_tree, int* keys, size_t n, int numthreads)
+{
+    if (!n) return;
+    if (numthreads < 1) numthreads = 1;
+    if (numthreads > AVL_MAXTHREADS) numthreads = AVL_MAXTHREADS;
+    /* sort the keys, and allocate their nodes up front, so that the workers
+     * need not allocate
+     */
+    int* sorted = (int*) E_Malloc(sizeof(int) * n, AVL_PushBatch);
+    AVL_Node** nodes = (AVL_Node**) E_Malloc(sizeof(AVL_Node*) * n,
+                                             AVL_PushBatch);
+    E_Memcpy(sorted, keys, sizeof(int) * n);
+    qsort(sorted, n, sizeof(int), AVL_CompareInts);
+    for (size_t i = 0; i < n; ++i) nodes[i] = AVL_InitNode(p_tree, sorted[i]);
+    E_Free(sorted);
+    /* split the tree into a few times as many parts as there are threads, to
+     * even out the work if the keys are skewed
+     */
+    AVL_Batch batch;
+    AVL_Node* pivots[AVL_MAXPARTS];
+    int numlevels = 0;
+    while ((1 << numlevels) < numthreads << 2 &&
+           (2 << numlevels) <= AVL_MAXPARTS)
+        ++numlevels;
+    batch.p_tree = p_tree;
+    batch.nodes = nodes;
+    batch.numparts = 0;
+    AVL_Split(p_tree->p_root, numlevels, batch.parts, pivots, &batch.numparts);
+    if (batch.numparts < 1 << numlevels)
+    {
+        size_t nummerged;
+        AVL_Node** merged = AVL_MergeNodes(p_tree, nodes, n, &nummerged);
+        E_Free(nodes);
+        p_tree->p_root = AVL_BuildBatch(&batch, merged, nummerged,
+                                        numthreads);
+        E_Free(merged);
+        return;
+    }
+    /* each part takes the keys up to the pivot after it, the same way as
+     * `AVL_Push` sends the keys equal to a node to its left
+     */
+    size_t end = 0;
+    for (int part = 0; part < batch.numparts; ++part)
+    {
+        batch.starts[part] = end;
+        if (part == batch.numparts - 1) end = n;
+        else while (end < n && nodes[end]->data <= pivots[part]->data) ++end;
+        batch.ends[part] = end;
+    }
+    AVL_RunBatch(&batch, AVL_BatchWorker, numthreads);
+    E_Free(nodes);
+    /* stitch the parts back together around the pivots */
+    AVL_Node* p_root = batch.parts[0];
+    for (int part = 1; part < batch.numparts; ++part)
+        p_root = AVL_Join(p_root, pivots[part - 1], batch.parts[part]);
+    p_tree->p_root = p_root;
 }
 
 int AVL_Depth (AVL_Tree* p_tree)
 {
     if (!p_tree) return 0;
-    return AVL_Depth_(p_tree->p_root);
+    return AVL_Height(p_tree->p_root);
 }
 
 void AVL_Destroy (AVL_Tree* p_tree)
 {
     if (!p_tree) return;
-    AVL_Destroy_(p_tree->p_root);
+    /* free the nodes in post-order, each after both of its children, so
+     * that none is read again once freed–the slab allocator reuses the
+     * memory of the free nodes
+     */
+    AVL_Iter iter;
+    AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, AVL_POSTORDER);
+    while (p_node)
+    {
+        AVL_Node* p_next = AVL_IterNext(&iter);
+        AVL_FreeNode(p_tree, p_node);
+        p_node = p_next;
+    }
+    if (p_tree->p_bulk) E_Free(p_tree->p_bulk);
     E_Free(p_tree);
 }
 
@@ -185,5 +830,5 @@ void AVL_Dump (AVL_Tree tree)
 {
     AVL_Node* p_root = tree.p_root;
     printf("AVL tree @%p:\n\n", (byte*) p_root);
-    AVL_PrintPreOrder(p_root);
+    AVL_PrintPreOrder(&tree);
 }
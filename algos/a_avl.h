@@ -11,36 +11,204 @@
  *      Balancing is performed at each insertion to the tree to keep the depth
  *      of the tree at a minimum with the intention of preserving the
  *      `O(log n)` search complexity.
+ *
+ *      Nodes are looked up with `AVL_Find`, and the ones within a range of
+ *      keys with `AVL_LowerBound`, `AVL_UpperBound` and `AVL_VisitRange`,
+ *      all in `O(log n)` plus the number of nodes in the range. The whole of
+ *      a tree can be walked in order, in pre-order or in post-order with
+ *      `AVL_IterBegin` and `AVL_IterNext`, without recursion or allocations.
+ *
+ *      Built with `AVL_SIZES` defined, and once asked for with
+ *      `AVL_TrackSizes`, each node also keeps the size of its subtree, so
+ *      that the `k`th smallest key can be found with `AVL_Select`, and the
+ *      number of keys below any key with `AVL_Rank`, in `O(log n)`. It is off
+ *      by default, as it grows every node by 8 bytes, and it has to be the
+ *      same for every file including this one.
+ *
+ *      A tree that is done changing can be frozen with `AVL_Freeze` into a
+ *      flat array of its keys, in which lookups take far fewer cache misses
+ *      than following the nodes.
+ *
+ *      The nodes can be allocated from a slab instead of `E_Malloc`, see
+ *      `AVL_UseSlab`. A tree can also be bulk-loaded from sorted keys with
+ *      `AVL_BuildSorted`, in `O(n)`, out of a single block of nodes, and
+ *      large batches of keys can be pushed on several threads at once with
+ *      `AVL_PushBatch`.
  */
 
 #ifndef a_avl_h
 
+#include "e_slab.h"
+
 #define a_avl_h
 #define a_avl_h_AVL_Tree AVL_Tree
 #define a_avl_h_AVL_Node AVL_Node
 #define a_avl_h_AVL_InitTree AVL_InitTree
+#define a_avl_h_AVL_UseSlab AVL_UseSlab
+#define a_avl_h_AVL_BuildSorted AVL_BuildSorted
 #define a_avl_h_AVL_IsEmpty AVL_IsEmpty
 #define a_avl_h_AVL_Push AVL_Push
+#define a_avl_h_AVL_PushBatch AVL_PushBatch
+#define a_avl_h_AVL_Find AVL_Find
+#define a_avl_h_AVL_Remove AVL_Remove
+#define a_avl_h_AVL_LowerBound AVL_LowerBound
+#define a_avl_h_AVL_UpperBound AVL_UpperBound
+#define a_avl_h_AVL_Visitor AVL_Visitor
+#define a_avl_h_AVL_VisitRange AVL_VisitRange
+#define a_avl_h_AVL_Frozen AVL_Frozen
+#define a_avl_h_AVL_Freeze AVL_Freeze
+#define a_avl_h_AVL_FrozenLowerBound AVL_FrozenLowerBound
+#define a_avl_h_AVL_FrozenContains AVL_FrozenContains
+#define a_avl_h_AVL_FrozenDestroy AVL_FrozenDestroy
+#define a_avl_h_AVL_Iter AVL_Iter
+#define a_avl_h_AVL_IterBegin AVL_IterBegin
+#define a_avl_h_AVL_IterNext AVL_IterNext
 #define a_avl_h_AVL_Depth AVL_Depth
 #define a_avl_h_AVL_Destroy AVL_Destroy
 #define a_avl_h_AVL_Dump AVL_Dump
+#ifdef AVL_SIZES
+#define a_avl_h_AVL_TrackSizes AVL_TrackSizes
+#define a_avl_h_AVL_Select AVL_Select
+#define a_avl_h_AVL_Rank AVL_Rank
+#endif
+
 
+// more than enough for any tree that fits in memory, as an AVL tree of
+// height h has at least `fib(h + 2) - 1` nodes
+#define AVL_MAXHEIGHT 96
+
+// the orders `AVL_IterBegin` walks a tree in
+#define AVL_INORDER 0
+#define AVL_PREORDER 1
+#define AVL_POSTORDER 2
 
 typedef struct avl_node {
     int data;
+    int height; // of the subtree rooted at the node, 1 for a leaf
+#ifdef AVL_SIZES
+    int size; // the number of nodes in the subtree, see `AVL_TrackSizes`
+#endif
     struct avl_node* p_left;
     struct avl_node* p_right;
 } AVL_Node;
 
 typedef struct {
     AVL_Node* p_root;
+    E_Slab* p_slab; // where the nodes come from, `E_Malloc` if NULL
+    // the block of nodes laid out by `AVL_BuildSorted`, freed only along
+    // with the tree
+    AVL_Node* p_bulk;
+    size_t numbulk;
+#ifdef AVL_SIZES
+    int tracking; // keep the sizes of the subtrees up to date
+#endif
 } AVL_Tree;
 
+/* an immutable copy of the keys of a tree, laid out for fast lookups, see
+ * `AVL_Freeze`
+ */
+typedef struct {
+    int* keys; // in the Eytzinger order, starting at index 1
+    size_t numkeys;
+} AVL_Frozen;
+
+typedef void (*AVL_Visitor) (AVL_Node* p_node, void* p_context);
+
+/* a walk over the nodes of a tree, see `AVL_IterBegin` */
+typedef struct {
+    AVL_Node* stack[AVL_MAXHEIGHT]; // the nodes yet to be returned
+    int depth;
+    int order;
+} AVL_Iter;
+
 AVL_Tree* AVL_InitTree (void);
+AVL_Tree* AVL_BuildSorted (int* keys, size_t n);
+void AVL_UseSlab (AVL_Tree* p_tree, E_Slab* p_slab);
 int AVL_IsEmpty (AVL_Tree tree);
 void AVL_Push (AVL_Tree* p_tree, int data);
+void AVL_PushBatch (AVL_Tree* p_tree, int* keys, size_t n, int numthreads);
+AVL_Node* AVL_Find (AVL_Tree* p_tree, int data);
+int AVL_Remove (AVL_Tree* p_tree, int data);
+AVL_Node* AVL_LowerBound (AVL_Tree* p_tree, int data);
+AVL_Node* AVL_UpperBound (AVL_Tree* p_tree, int data);
+size_t AVL_VisitRange (AVL_Tree* p_tree, int lo, int hi, AVL_Visitor visit,
+                       void* p_context);
+AVL_Frozen* AVL_Freeze (AVL_Tree* p_tree);
+const int* AVL_FrozenLowerBound (AVL_Frozen* p_frozen, int data);
+int AVL_FrozenContains (AVL_Frozen* p_frozen, int data);
+void AVL_FrozenDestroy (AVL_Frozen* p_frozen);
 int AVL_Depth (AVL_Tree* p_tree);
 void AVL_Destroy (AVL_Tree* p_tree);
 void AVL_Dump (AVL_Tree tree);
+#ifdef AVL_SIZES
+void AVL_TrackSizes (AVL_Tree* p_tree, int enabled);
+AVL_Node* AVL_Select (AVL_Tree* p_tree, size_t k);
+size_t AVL_Rank (AVL_Tree* p_tree, int data);
+#endif
+
+/* the iterators are defined right here, so that a walk inlines into the loop
+ * around it, without a call per node
+ */
+
+/* pushes the nodes from `p_node` down to the first one to be visited, i.e.,
+ * the leftmost one in order, or the leftmost leaf in post-order, going right
+ * only where there's no left
+ */
+static inline void AVL_IterDescend_ (AVL_Iter* p_iter, AVL_Node* p_node)
+{
+    while (p_node)
+    {
+        p_iter->stack[p_iter->depth++] = p_node;
+        if (p_iter->order == AVL_INORDER) p_node = p_node->p_left;
+        else p_node = p_node->p_left ? p_node->p_left : p_node->p_right;
+    }
+}
+
+/* the node after the one last returned, or NULL once all have been–in
+ * post-order, a node is not looked at again once returned, so it can be freed
+ * right away
+ */
+static inline AVL_Node* AVL_IterNext (AVL_Iter* p_iter)
+{
+    if (!p_iter->depth) return NULL;
+    AVL_Node* p_node = p_iter->stack[--p_iter->depth];
+    if (p_iter->order == AVL_INORDER) AVL_IterDescend_(p_iter, p_node->p_right);
+    else if (p_iter->order == AVL_PREORDER)
+    {
+        // the right subtree waits under the left one
+        if (p_node->p_right)
+            p_iter->stack[p_iter->depth++] = p_node->p_right;
+        if (p_node->p_left) p_iter->stack[p_iter->depth++] = p_node->p_left;
+    }
+    else if (p_iter->depth)
+    {
+        /* coming up from the left of the parent, its right subtree is next,
+         * and otherwise the parent itself
+         */
+        AVL_Node* p_parent = p_iter->stack[p_iter->depth - 1];
+        if (p_parent->p_left == p_node)
+            AVL_IterDescend_(p_iter, p_parent->p_right);
+    }
+    return p_node;
+}
+
+/* starts a walk over the nodes of a tree in the given order, one of
+ * `AVL_INORDER`, `AVL_PREORDER` and `AVL_POSTORDER`, returning the first node,
+ * or NULL if the tree is empty–the iterator keeps its own stack, so nothing
+ * is allocated, and with the order known up front, the checks on it fold
+ * away once inlined
+ */
+static inline AVL_Node* AVL_IterBegin (AVL_Iter* p_iter, AVL_Tree* p_tree,
+                                       int order)
+{
+    p_iter->depth = 0;
+    p_iter->order = order;
+    if (order == AVL_PREORDER)
+    {
+        if (p_tree->p_root) p_iter->stack[p_iter->depth++] = p_tree->p_root;
+    }
+    else AVL_IterDescend_(p_iter, p_tree->p_root);
+    return AVL_IterNext(p_iter);
+}
 
 #endif
@@ -0,0 +1,340 @@
+/*
+ *  a_avlmap.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      An ordered map on top of an AVL tree, for keys other than a lone `int`.
+ *
+ *      Balancing works the same way as in "a_avl.c": each node keeps the
+ *      height of its subtree, and only the nodes along the path of an update
+ *      are rebalanced.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "e_malloc.h"
+#include "a_avlmap.h"
+
+// more than enough for any tree that fits in memory, see `AVL_MAXHEIGHT`
+#define AVLM_MAXHEIGHT 96
+
+/* the node allocated for each value by `AVLM_Put` */
+typedef struct {
+    AVLM_Node node;
+    void* p_value;
+} AVLM_Pair;
+
+static int AVLM_Height (AVLM_Node* p_node)
+{
+    return p_node ? p_node->height : 0;
+}
+
+static void AVLM_Update (AVLM_Node* p_node)
+{
+    int heightleft = AVLM_Height(p_node->p_left);
+    int heightright = AVLM_Height(p_node->p_right);
+    p_node->height = (heightleft >= heightright ? heightleft : heightright) + 1;
+}
+
+static AVLM_Node* AVLM_RotateLeft (AVLM_Node* p_node)
+{
+    AVLM_Node* p_newroot = p_node->p_right;
+    p_node->p_right = p_newroot->p_left;
+    p_newroot->p_left = p_node;
+    AVLM_Update(p_node);
+    AVLM_Update(p_newroot);
+    return p_newroot;
+}
+
+static AVLM_Node* AVLM_RotateRight (AVLM_Node* p_node)
+{
+    AVLM_Node* p_newroot = p_node->p_left;
+    p_node->p_left = p_newroot->p_right;
+    p_newroot->p_right = p_node;
+    AVLM_Update(p_node);
+    AVLM_Update(p_newroot);
+    return p_newroot;
+}
+
+static AVLM_Node* AVLM_Balance (AVLM_Node* p_node)
+{
+    int balancefactor = AVLM_Height(p_node->p_left) -
+                        AVLM_Height(p_node->p_right);
+    if (balancefactor < -1)
+    {
+        if (AVLM_Height(p_node->p_right->p_left) >
+            AVLM_Height(p_node->p_right->p_right))
+            p_node->p_right = AVLM_RotateRight(p_node->p_right);
+        return AVLM_RotateLeft(p_node);
+    }
+    if (balancefactor > 1)
+    {
+        if (AVLM_Height(p_node->p_left->p_right) >
+            AVLM_Height(p_node->p_left->p_left))
+            p_node->p_left = AVLM_RotateLeft(p_node->p_left);
+        return AVLM_RotateRight(p_node);
+    }
+    AVLM_Update(p_node);
+    return p_node;
+}
+
+/* rebalances the subtrees at the links of `path` from the bottom up, until
+ * one turns out to be as high as it was before
+ */
+static void AVLM_Rebalance (AVLM_Node*** path, int depth)
+{
+    while (depth--)
+    {
+        AVLM_Node* p_node = *path[depth];
+        int height = p_node->height;
+        *path[depth] = AVLM_Balance(p_node);
+        if ((*path[depth])->height == height) break;
+    }
+}
+
+AVLM_Map* AVLM_Init (AVLM_Comparator compare)
+{
+    AVLM_Map* p_map = (AVLM_Map*) E_Malloc(sizeof(AVLM_Map), AVLM_Init);
+    p_map->p_root = NULL;
+    p_map->compare = compare;
+    p_map->size = 0;
+    p_map->owning = 0;
+    return p_map;
+}
+
+/* a comparator for keys that point to null-terminated strings */
+int AVLM_CompareStrings (AVLM_Key a, AVLM_Key b)
+{
+    return strcmp((const char*) a.p, (const char*) b.p);
+}
+
+/* each walk down the tree comes in two copies, one calling the comparator of
+ * the map and one comparing the keys as integers in place, and the map picks
+ * one of them once per call, sparing the maps without a comparator a call
+ * per node
+ */
+
+/* the link to the node with `key`, or to where it would be linked in,
+ * along with the links followed on the way down to it
+ */
+static AVLM_Node** AVLM_Descend_ (AVLM_Map* p_map, AVLM_Key key,
+                                  AVLM_Node*** path, int* p_depth)
+{
+    AVLM_Comparator compare = p_map->compare;
+    AVLM_Node** p_link = &p_map->p_root;
+    int order;
+    while (*p_link && (order = compare(key, (*p_link)->key)))
+    {
+        path[(*p_depth)++] = p_link;
+        p_link = order < 0 ? &(*p_link)->p_left : &(*p_link)->p_right;
+    }
+    return p_link;
+}
+
+static AVLM_Node** AVLM_DescendInts_ (AVLM_Map* p_map, AVLM_Key key,
+                                      AVLM_Node*** path, int* p_depth)
+{
+    AVLM_Node** p_link = &p_map->p_root;
+    while (*p_link && (*p_link)->key.i != key.i)
+    {
+        path[(*p_depth)++] = p_link;
+        p_link = key.i < (*p_link)->key.i ? &(*p_link)->p_left
+                                          : &(*p_link)->p_right;
+    }
+    return p_link;
+}
+
+static AVLM_Node** AVLM_Descend (AVLM_Map* p_map, AVLM_Key key,
+                                 AVLM_Node*** path, int* p_depth)
+{
+    if (!p_map->compare) return AVLM_DescendInts_(p_map, key, path, p_depth);
+    return AVLM_Descend_(p_map, key, path, p_depth);
+}
+
+static AVLM_Node* AVLM_Find_ (AVLM_Map* p_map, AVLM_Key key)
+{
+    AVLM_Comparator compare = p_map->compare;
+    AVLM_Node* p_node = p_map->p_root;
+    int order;
+    while (p_node && (order = compare(key, p_node->key)))
+        p_node = order < 0 ? p_node->p_left : p_node->p_right;
+    return p_node;
+}
+
+static AVLM_Node* AVLM_FindInts_ (AVLM_Map* p_map, AVLM_Key key)
+{
+    AVLM_Node* p_node = p_map->p_root;
+    while (p_node && p_node->key.i != key.i)
+        p_node = key.i < p_node->key.i ? p_node->p_left : p_node->p_right;
+    return p_node;
+}
+
+static AVLM_Node* AVLM_LowerBound_ (AVLM_Map* p_map, AVLM_Key key)
+{
+    AVLM_Comparator compare = p_map->compare;
+    AVLM_Node *p_node = p_map->p_root, *p_bound = NULL;
+    while (p_node)
+    {
+        if (compare(p_node->key, key) >= 0)
+        {
+            p_bound = p_node;
+            p_node = p_node->p_left;
+        }
+        else p_node = p_node->p_right;
+    }
+    return p_bound;
+}
+
+static AVLM_Node* AVLM_LowerBoundInts_ (AVLM_Map* p_map, AVLM_Key key)
+{
+    AVLM_Node *p_node = p_map->p_root, *p_bound = NULL;
+    while (p_node)
+    {
+        if (p_node->key.i >= key.i)
+        {
+            p_bound = p_node;
+            p_node = p_node->p_left;
+        }
+        else p_node = p_node->p_right;
+    }
+    return p_bound;
+}
+
+static AVLM_Node* AVLM_Insert_ (AVLM_Map* p_map, AVLM_Node* p_node)
+{
+    AVLM_Node** path[AVLM_MAXHEIGHT];
+    int depth = 0;
+    AVLM_Node** p_link = AVLM_Descend(p_map, p_node->key, path, &depth);
+    if (*p_link) return *p_link;
+    p_node->p_left = NULL;
+    p_node->p_right = NULL;
+    p_node->height = 1;
+    *p_link = p_node;
+    ++p_map->size;
+    AVLM_Rebalance(path, depth);
+    return NULL;
+}
+
+/* links in a node embedded by the caller, with its key already set, and
+ * returns NULL–or, leaving the map as it is, the node already in the map with
+ * the same key, or `p_node` itself if the map owns its nodes
+ */
+AVLM_Node* AVLM_Insert (AVLM_Map* p_map, AVLM_Node* p_node)
+{
+    if (p_map->owning)
+    {
+        printf("AVLM_Insert: Map owns its nodes.\n");
+        return p_node;
+    }
+    return AVLM_Insert_(p_map, p_node);
+}
+
+/* unlinks the node with `key` and returns it, or NULL if there's none–the
+ * node is left to the caller
+ */
+AVLM_Node* AVLM_Erase (AVLM_Map* p_map, AVLM_Key key)
+{
+    AVLM_Node** path[AVLM_MAXHEIGHT];
+    int depth = 0;
+    AVLM_Node** p_link = AVLM_Descend(p_map, key, path, &depth);
+    AVLM_Node* p_node = *p_link;
+    if (!p_node) return NULL;
+    if (!p_node->p_left || !p_node->p_right)
+        *p_link = p_node->p_left ? p_node->p_left : p_node->p_right;
+    else
+    {
+        /* put the successor in place of the node */
+        int nodedepth = depth;
+        path[depth++] = p_link;
+        AVLM_Node** p_succlink = &p_node->p_right;
+        while ((*p_succlink)->p_left)
+        {
+            path[depth++] = p_succlink;
+            p_succlink = &(*p_succlink)->p_left;
+        }
+        AVLM_Node* p_succ = *p_succlink;
+        *p_succlink = p_succ->p_right;
+        p_succ->p_left = p_node->p_left;
+        p_succ->p_right = p_node->p_right;
+        p_succ->height = p_node->height;
+        *p_link = p_succ;
+        if (depth > nodedepth + 1) path[nodedepth + 1] = &p_succ->p_right;
+    }
+    --p_map->size;
+    AVLM_Rebalance(path, depth);
+    return p_node;
+}
+
+AVLM_Node* AVLM_Find (AVLM_Map* p_map, AVLM_Key key)
+{
+    if (!p_map->compare) return AVLM_FindInts_(p_map, key);
+    return AVLM_Find_(p_map, key);
+}
+
+/* the node with the smallest key not less than `key`, or NULL */
+AVLM_Node* AVLM_LowerBound (AVLM_Map* p_map, AVLM_Key key)
+{
+    if (!p_map->compare) return AVLM_LowerBoundInts_(p_map, key);
+    return AVLM_LowerBound_(p_map, key);
+}
+
+/* maps `key` to `p_value`, returning 1 if the key is new to the map, and 0
+ * if its value has been replaced
+ */
+int AVLM_Put (AVLM_Map* p_map, AVLM_Key key, void* p_value)
+{
+    if (!p_map->owning && p_map->size)
+    {
+        printf("AVLM_Put: Map holds intrusive nodes.\n");
+        return 0;
+    }
+    p_map->owning = 1;
+    AVLM_Node* p_node = AVLM_Find(p_map, key);
+    if (p_node)
+    {
+        ((AVLM_Pair*) p_node)->p_value = p_value;
+        return 0;
+    }
+    AVLM_Pair* p_pair = (AVLM_Pair*) E_Malloc(sizeof(AVLM_Pair), AVLM_Put);
+    p_pair->node.key = key;
+    p_pair->p_value = p_value;
+    AVLM_Insert_(p_map, &p_pair->node);
+    return 1;
+}
+
+void* AVLM_Get (AVLM_Map* p_map, AVLM_Key key)
+{
+    AVLM_Node* p_node = AVLM_Find(p_map, key);
+    return p_node && p_map->owning ? ((AVLM_Pair*) p_node)->p_value : NULL;
+}
+
+int AVLM_Remove (AVLM_Map* p_map, AVLM_Key key)
+{
+    if (!p_map->owning) return 0;
+    AVLM_Node* p_node = AVLM_Erase(p_map, key);
+    if (!p_node) return 0;
+    E_Free(p_node);
+    return 1;
+}
+
+/* frees the map, along with the nodes allocated by `AVLM_Put`–the intrusive
+ * ones are left to their owners
+ */
+void AVLM_Destroy (AVLM_Map* p_map)
+{
+    if (!p_map) return;
+    AVLM_Node* stack[AVLM_MAXHEIGHT];
+    int depth = 0;
+    if (p_map->owning && p_map->p_root) stack[depth++] = p_map->p_root;
+    while (depth)
+    {
+        AVLM_Node* p_node = stack[--depth];
+        if (p_node->p_left) stack[depth++] = p_node->p_left;
+        if (p_node->p_right) stack[depth++] = p_node->p_right;
+        E_Free(p_node);
+    }
+    E_Free(p_map);
+}
@@ -0,0 +1,85 @@
+/*
+ *  a_avlmap.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      An ordered map on top of an AVL tree, for keys other than a lone `int`.
+ *
+ *      Keys are either 64-bit integers or pointers, e.g., to strings, and are
+ *      ordered by the comparator given to `AVLM_Init`. Without a comparator,
+ *      the keys are compared as integers, right in the loops that walk the
+ *      tree, without a call per node.
+ *
+ *      The nodes can be embedded in the records of the caller (intrusive), to
+ *      be linked in with `AVLM_Insert` and unlinked with `AVLM_Erase`, and the
+ *      record is found back from its node with `AVLM_ENTRY`. Otherwise, the
+ *      map allocates a node of its own for each value with `AVLM_Put`. A map
+ *      holds either kind of node, but not both.
+ */
+
+#ifndef a_avlmap_h
+
+#include <stddef.h>
+
+#include "t_typedef.h"
+
+#define a_avlmap_h
+#define a_avlmap_h_AVLM_Key AVLM_Key
+#define a_avlmap_h_AVLM_Comparator AVLM_Comparator
+#define a_avlmap_h_AVLM_Node AVLM_Node
+#define a_avlmap_h_AVLM_Map AVLM_Map
+#define a_avlmap_h_AVLM_Init AVLM_Init
+#define a_avlmap_h_AVLM_CompareStrings AVLM_CompareStrings
+#define a_avlmap_h_AVLM_Insert AVLM_Insert
+#define a_avlmap_h_AVLM_Erase AVLM_Erase
+#define a_avlmap_h_AVLM_Find AVLM_Find
+#define a_avlmap_h_AVLM_LowerBound AVLM_LowerBound
+#define a_avlmap_h_AVLM_Put AVLM_Put
+#define a_avlmap_h_AVLM_Get AVLM_Get
+#define a_avlmap_h_AVLM_Remove AVLM_Remove
+#define a_avlmap_h_AVLM_Destroy AVLM_Destroy
+
+typedef union {
+    long long i;
+    const void* p;
+} AVLM_Key;
+
+/* keys out of integers and pointers */
+#define AVLM_INT(x) ((AVLM_Key) { .i = (x) })
+#define AVLM_PTR(x) ((AVLM_Key) { .p = (x) })
+
+// the record of type `type` that embeds `p_node` as its `member`
+#define AVLM_ENTRY(p_node, type, member) \
+    ((type*) ((byte*) (p_node) - offsetof(type, member)))
+
+// negative, zero or positive as `a` is less than, equal to or greater than `b`
+typedef int (*AVLM_Comparator) (AVLM_Key a, AVLM_Key b);
+
+typedef struct avlm_node {
+    AVLM_Key key;
+    struct avlm_node* p_left;
+    struct avlm_node* p_right;
+    int height;
+} AVLM_Node;
+
+typedef struct {
+    AVLM_Node* p_root;
+    AVLM_Comparator compare; // compare the keys as integers if NULL
+    size_t size;
+    int owning; // the nodes had been allocated by `AVLM_Put`
+} AVLM_Map;
+
+AVLM_Map* AVLM_Init (AVLM_Comparator compare);
+int AVLM_CompareStrings (AVLM_Key a, AVLM_Key b);
+AVLM_Node* AVLM_Insert (AVLM_Map* p_map, AVLM_Node* p_node);
+AVLM_Node* AVLM_Erase (AVLM_Map* p_map, AVLM_Key key);
+AVLM_Node* AVLM_Find (AVLM_Map* p_map, AVLM_Key key);
+AVLM_Node* AVLM_LowerBound (AVLM_Map* p_map, AVLM_Key key);
+int AVLM_Put (AVLM_Map* p_map, AVLM_Key key, void* p_value);
+void* AVLM_Get (AVLM_Map* p_map, AVLM_Key key);
+int AVLM_Remove (AVLM_Map* p_map, AVLM_Key key);
+void AVLM_Destroy (AVLM_Map* p_map);
+
+#endif
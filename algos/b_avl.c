@@ -0,0 +1,360 @@
+/*
+ *  b_avl.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Benchmarks for the AVL trees.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "e_malloc.h"
+#include "a_avl.h"
+#include "a_avlmap.h"
+#include "b_bench.h"
+
+#define B_NUMKEYS 1000000
+#define B_NUMOLDRUNS 3
+#define B_NUMLOOKUPS 1000000
+#define B_NUMBASEKEYS 100000
+#define B_NUMITERKEYS 10000000
+
+/* the way `AVL_Push` used to be, kept around to compare against: insert
+ * without looking back, then rebalance the entire tree from the root
+ */
+static void B_OldPush_ (AVL_Node* p_root, AVL_Node* p_node)
+{
+    if (p_root->data >= p_node->data)
+    {
+        if (p_root->p_left == NULL) p_root->p_left = p_node;
+        else B_OldPush_(p_root->p_left, p_node);
+    }
+    else if (p_root->data < p_node->data)
+    {
+        if (p_root->p_right == NULL) p_root->p_right = p_node;
+        else B_OldPush_(p_root->p_right, p_node);
+    }
+}
+
+static int B_OldBalance_ (AVL_Node* p_node, AVL_Node* p_parent,
+                          AVL_Tree* p_tree)
+{
+    if (p_node->p_left == NULL && p_node->p_right == NULL) return 1;
+    int depthleft = 0, depthright = 0;
+    if (p_node->p_left)
+        depthleft = B_OldBalance_(p_node->p_left, p_node, p_tree);
+    if (p_node->p_right)
+        depthright = B_OldBalance_(p_node->p_right, p_node, p_tree);
+    int balancefactor = depthleft - depthright;
+    if (balancefactor < -1)
+    {
+        if (p_node->p_right->p_left != NULL)
+        {
+            AVL_Node* p_newintroot = p_node->p_right->p_left;
+            p_node->p_right->p_left = p_newintroot->p_right;
+            p_newintroot->p_right = p_node->p_right;
+            p_node->p_right = p_newintroot;
+        }
+        AVL_Node* p_newroot = p_node->p_right;
+        p_node->p_right = p_newroot->p_left;
+        p_newroot->p_left = p_node;
+        if (p_parent == NULL) p_tree->p_root = p_newroot;
+        else if (p_parent->p_left == p_node) p_parent->p_left = p_newroot;
+        else if (p_parent->p_right == p_node) p_parent->p_right = p_newroot;
+        return depthright;
+    }
+    else if (balancefactor > 1)
+    {
+        if (p_node->p_left->p_right != NULL)
+        {
+            AVL_Node* p_newintroot = p_node->p_left->p_right;
+            p_node->p_left->p_right = p_newintroot->p_left;
+            p_newintroot->p_left = p_node->p_left;
+            p_node->p_left = p_newintroot;
+        }
+        AVL_Node* p_newroot = p_node->p_left;
+        p_node->p_left = p_newroot->p_right;
+        p_newroot->p_right = p_node;
+        if (p_parent == NULL) p_tree->p_root = p_newroot;
+        else if (p_parent->p_left == p_node) p_parent->p_left = p_newroot;
+        else if (p_parent->p_right == p_node) p_parent->p_right = p_newroot;
+        return depthleft;
+    }
+    return (depthleft >= depthright ? depthleft : depthright) + 1;
+}
+
+static void B_OldPush (AVL_Tree* p_tree, int data)
+{
+    AVL_Node* p_node = (AVL_Node*) E_Malloc(sizeof(AVL_Node), B_OldPush);
+    p_node->data = data;
+    p_node->height = 1;
+    p_node->p_left = NULL;
+    p_node->p_right = NULL;
+    if (AVL_IsEmpty(*p_tree)) p_tree->p_root = p_node;
+    else B_OldPush_(p_tree->p_root, p_node);
+    B_OldBalance_(p_tree->p_root, NULL, p_tree);
+}
+
+/* pushes `numkeys` random keys, with the old `AVL_Push` if asked for */
+static double B_Push (int numkeys, int old)
+{
+    AVL_Tree* p_tree = AVL_InitTree();
+    unsigned int seed = 42;
+    double start = B_Now();
+    for (int i = 0; i < numkeys; ++i)
+    {
+        int key = B_Random(&seed);
+        if (old) B_OldPush(p_tree, key);
+        else AVL_Push(p_tree, key);
+    }
+    double seconds = B_Now() - start;
+    AVL_Destroy(p_tree);
+    return seconds;
+}
+
+/* the old `AVL_Push` is `O(n)` per key, so it is only run on a few smaller
+ * trees, next to the new one–then the new one builds a full-sized tree
+ */
+void B_AVLPush (void)
+{
+    E_Init(1);
+    char name[64];
+    for (int numkeys = 1000, i = 0; i < B_NUMOLDRUNS; numkeys <<= 2, ++i)
+    {
+        sprintf(name, "AVL_Push (old), %d keys", numkeys);
+        B_Report(name, numkeys, B_Push(numkeys, 1));
+        sprintf(name, "AVL_Push, %d keys", numkeys);
+        B_Report(name, numkeys, B_Push(numkeys, 0));
+    }
+    sprintf(name, "AVL_Push, %d keys", B_NUMKEYS);
+    B_Report(name, B_NUMKEYS, B_Push(B_NUMKEYS, 0));
+    E_Destroy();
+}
+
+/* the tallest an AVL tree of `numkeys` keys can get */
+static int B_MaxHeight (double numkeys)
+{
+    return (int) (1.4405 * log2(numkeys + 2) - 0.3277);
+}
+
+/* pushes a batch of random keys into a tree of `numbasekeys` random keys, one
+ * by one with `AVL_Push` if `numthreads` is 0, or with `AVL_PushBatch`
+ * otherwise
+ */
+static double B_PushBatch (int* keys, int numbasekeys, int numthreads)
+{
+    AVL_Tree* p_tree = AVL_InitTree();
+    unsigned int seed = 7;
+    for (int i = 0; i < numbasekeys; ++i) AVL_Push(p_tree, B_Random(&seed));
+    double start = B_Now();
+    if (numthreads) AVL_PushBatch(p_tree, keys, B_NUMKEYS, numthreads);
+    else for (int i = 0; i < B_NUMKEYS; ++i) AVL_Push(p_tree, keys[i]);
+    double seconds = B_Now() - start;
+    if (AVL_Depth(p_tree) > B_MaxHeight(numbasekeys + B_NUMKEYS))
+        printf("B_AVLPushBatch: The tree is out of balance.\n");
+    AVL_Destroy(p_tree);
+    return seconds;
+}
+
+void B_AVLPushBatch (void)
+{
+    E_Init(1);
+    int* keys = (int*) E_Malloc(sizeof(int) * B_NUMKEYS, B_AVLPushBatch);
+    unsigned int seed = 42;
+    for (int i = 0; i < B_NUMKEYS; ++i) keys[i] = B_Random(&seed);
+    char name[64];
+    /* `B_NUMKEYS` keys into an empty tree, which is built from the batch, and
+     * into a full one
+     */
+    for (int numbasekeys = 0; numbasekeys <= B_NUMBASEKEYS;
+         numbasekeys += B_NUMBASEKEYS)
+    {
+        sprintf(name, "AVL_Push into %d keys", numbasekeys);
+        B_Report(name, B_NUMKEYS, B_PushBatch(keys, numbasekeys, 0));
+        for (int numthreads = 1; numthreads <= 8; numthreads <<= 1)
+        {
+            sprintf(name, "AVL_PushBatch into %d keys, %d threads",
+                    numbasekeys, numthreads);
+            B_Report(name, B_NUMKEYS,
+                     B_PushBatch(keys, numbasekeys, numthreads));
+        }
+    }
+    E_Free(keys);
+    E_Destroy();
+}
+
+/* the way to walk a tree before there were iterators, kept around to compare
+ * against
+ */
+static void B_Walk_ (AVL_Node* p_node, long long* p_sum)
+{
+    if (!p_node) return;
+    B_Walk_(p_node->p_left, p_sum);
+    *p_sum += p_node->data;
+    B_Walk_(p_node->p_right, p_sum);
+}
+
+/* adds up the keys of a tree in the given order, so that the walk isn't
+ * optimized away–called with a constant order, for the checks on it to fold
+ * away
+ */
+static inline long long B_IterSum (AVL_Tree* p_tree, int order)
+{
+    long long sum = 0;
+    AVL_Iter iter;
+    for (AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, order); p_node;
+         p_node = AVL_IterNext(&iter))
+        sum += p_node->data;
+    return sum;
+}
+
+/* walks a tree of random keys in each order */
+void B_AVLIter (void)
+{
+    static const char* names[] = { "AVL_IterNext, in-order",
+                                   "AVL_IterNext, pre-order",
+                                   "AVL_IterNext, post-order" };
+    E_Init(1);
+    int* keys = (int*) E_Malloc(sizeof(int) * B_NUMITERKEYS, B_AVLIter);
+    unsigned int seed = 42;
+    for (int i = 0; i < B_NUMITERKEYS; ++i) keys[i] = B_Random(&seed);
+    AVL_Tree* p_tree = AVL_InitTree();
+    AVL_PushBatch(p_tree, keys, B_NUMITERKEYS, 1);
+    E_Free(keys);
+    long long sum = 0;
+    double start = B_Now();
+    B_Walk_(p_tree->p_root, &sum);
+    B_Report("recursive walk, in-order", B_NUMITERKEYS, B_Now() - start);
+    for (int order = AVL_INORDER; order <= AVL_POSTORDER; ++order)
+    {
+        long long itersum;
+        start = B_Now();
+        if (order == AVL_INORDER) itersum = B_IterSum(p_tree, AVL_INORDER);
+        else if (order == AVL_PREORDER)
+            itersum = B_IterSum(p_tree, AVL_PREORDER);
+        else itersum = B_IterSum(p_tree, AVL_POSTORDER);
+        B_Report(names[order], B_NUMITERKEYS, B_Now() - start);
+        if (itersum != sum) printf("B_AVLIter: The sums do not match.\n");
+    }
+    start = B_Now();
+    AVL_Destroy(p_tree);
+    B_Report("AVL_Destroy", B_NUMITERKEYS, B_Now() - start);
+    E_Destroy();
+}
+
+/* builds a tree out of sorted keys, either by pushing them one by one or in
+ * bulk, and then walks the whole of it in order
+ */
+void B_AVLBuild (void)
+{
+    E_Init(1);
+    int* keys = (int*) E_Malloc(sizeof(int) * B_NUMKEYS, B_AVLBuild);
+    for (int i = 0; i < B_NUMKEYS; ++i) keys[i] = i;
+    for (int bulk = 0; bulk < 2; ++bulk)
+    {
+        double start = B_Now();
+        AVL_Tree* p_tree;
+        if (bulk) p_tree = AVL_BuildSorted(keys, B_NUMKEYS);
+        else
+        {
+            p_tree = AVL_InitTree();
+            for (int i = 0; i < B_NUMKEYS; ++i) AVL_Push(p_tree, keys[i]);
+        }
+        B_Report(bulk ? "AVL_BuildSorted" : "AVL_Push, ascending", B_NUMKEYS,
+                 B_Now() - start);
+        start = B_Now();
+        AVL_VisitRange(p_tree, 0, B_NUMKEYS, NULL, NULL);
+        B_Report(bulk ? "AVL_VisitRange, bulk-loaded" :
+                        "AVL_VisitRange, pushed", B_NUMKEYS, B_Now() - start);
+        AVL_Destroy(p_tree);
+    }
+    E_Free(keys);
+    E_Destroy();
+}
+
+/* looks random keys up in trees of growing sizes, by following the nodes,
+ * and in the frozen copies of the trees
+ */
+void B_AVLFrozen (void)
+{
+    E_Init(1);
+    char name[64];
+    for (int numkeys = 1000; numkeys <= B_NUMKEYS; numkeys *= 10)
+    {
+        AVL_Tree* p_tree = AVL_InitTree();
+        unsigned int seed = 42;
+        for (int i = 0; i < numkeys; ++i)
+            AVL_Push(p_tree, B_Random(&seed) % (numkeys << 1));
+        AVL_Frozen* p_frozen = AVL_Freeze(p_tree);
+        /* both look the same keys up, and should come to the same answers */
+        long long sums[2] = { 0, 0 };
+        for (int frozen = 0; frozen < 2; ++frozen)
+        {
+            seed = 7;
+            double start = B_Now();
+            for (int i = 0; i < B_NUMLOOKUPS; ++i)
+            {
+                int key = B_Random(&seed) % (numkeys << 1);
+                if (frozen)
+                {
+                    const int* p_key = AVL_FrozenLowerBound(p_frozen, key);
+                    sums[frozen] += p_key ? *p_key : -1;
+                }
+                else
+                {
+                    AVL_Node* p_node = AVL_LowerBound(p_tree, key);
+                    sums[frozen] += p_node ? p_node->data : -1;
+                }
+            }
+            double seconds = B_Now() - start;
+            sprintf(name, "%s, %d keys", frozen ? "AVL_FrozenLowerBound" :
+                                                  "AVL_LowerBound", numkeys);
+            B_Report(name, B_NUMLOOKUPS, seconds);
+        }
+        if (sums[0] != sums[1]) printf("B_AVLFrozen: Lookups differ!\n");
+        AVL_FrozenDestroy(p_frozen);
+        AVL_Destroy(p_tree);
+    }
+    E_Destroy();
+}
+
+static int B_CompareInts (AVLM_Key a, AVLM_Key b)
+{
+    return (a.i > b.i) - (a.i < b.i);
+}
+
+/* looks integer keys up in maps with and without a comparator, to tell how
+ * much the call to the comparator costs
+ */
+void B_AVLMap (void)
+{
+    E_Init(1);
+    char name[64];
+    // a small map fits in the cache, where the comparator is what's left
+    for (int numkeys = 10000; numkeys <= B_NUMKEYS; numkeys *= 100)
+    {
+        for (int generic = 0; generic < 2; ++generic)
+        {
+            AVLM_Map* p_map = AVLM_Init(generic ? B_CompareInts : NULL);
+            unsigned int seed = 42;
+            for (int i = 0; i < numkeys; ++i)
+                AVLM_Put(p_map, AVLM_INT(B_Random(&seed) % (numkeys << 1)),
+                         NULL);
+            seed = 7;
+            size_t numfound = 0;
+            double start = B_Now();
+            for (int i = 0; i < B_NUMLOOKUPS; ++i)
+                numfound += AVLM_Find(p_map, AVLM_INT(B_Random(&seed) %
+                                                      (numkeys << 1))) != NULL;
+            sprintf(name, "AVLM_Find, %s, %d keys",
+                    generic ? "comparator" : "integers", numkeys);
+            B_Report(name, B_NUMLOOKUPS, B_Now() - start);
+            if (!numfound) printf("B_AVLMap: No keys found!\n");
+            AVLM_Destroy(p_map);
+        }
+    }
+    E_Destroy();
+}
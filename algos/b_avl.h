@@ -0,0 +1,28 @@
+/*
+ *  b_avl.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Benchmarks for the AVL trees.
+ */
+
+#ifndef b_avl_h
+
+#define b_avl_h
+#define b_avl_h_B_AVLPush B_AVLPush
+#define b_avl_h_B_AVLPushBatch B_AVLPushBatch
+#define b_avl_h_B_AVLIter B_AVLIter
+#define b_avl_h_B_AVLBuild B_AVLBuild
+#define b_avl_h_B_AVLFrozen B_AVLFrozen
+#define b_avl_h_B_AVLMap B_AVLMap
+
+void B_AVLPush (void);
+void B_AVLPushBatch (void);
+void B_AVLIter (void);
+void B_AVLBuild (void);
+void B_AVLFrozen (void);
+void B_AVLMap (void);
+
+#endif
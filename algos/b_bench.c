@@ -0,0 +1,42 @@
+/*
+ *  b_bench.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      A tiny harness for timing the benchmarks, along with a cheap random
+ *      number generator that is safe to use from multiple threads.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "b_bench.h"
+
+/* returns a monotonic timestamp in seconds */
+double B_Now (void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* xorshift32: the state is kept by the caller, so each thread can have its own
+ * sequence
+ */
+unsigned int B_Random (unsigned int* p_state)
+{
+    unsigned int x = *p_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x;
+}
+
+void B_Report (const char* name, double ops, double seconds)
+{
+    printf("%-40s %10.3f ms %10.2f Mops/s\n",
+           name, seconds * 1e3, ops / seconds * 1e-6);
+}
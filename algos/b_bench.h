@@ -0,0 +1,23 @@
+/*
+ *  b_bench.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      A tiny harness for timing the benchmarks, along with a cheap random
+ *      number generator that is safe to use from multiple threads.
+ */
+
+#ifndef b_bench_h
+
+#define b_bench_h
+#define b_bench_h_B_Now B_Now
+#define b_bench_h_B_Random B_Random
+#define b_bench_h_B_Report B_Report
+
+double B_Now (void);
+unsigned int B_Random (unsigned int* p_state);
+void B_Report (const char* name, double ops, double seconds);
+
+#endif
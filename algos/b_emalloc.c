@@ -0,0 +1,622 @@
+/*
+ *  b_emalloc.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Benchmarks for the custom memory allocator.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "t_typedef.h"
+#include "e_malloc.h"
+#include "e_slab.h"
+#include "m_matrix.h"
+#include "b_bench.h"
+
+#define B_MAXTHREADS 8
+#define B_NUMSLOTS 1024
+#define B_NUMOPS 1000000
+
+typedef struct {
+    unsigned int seed;
+    int libc; // use the C standard library instead of `E_Malloc`
+} B_Worker;
+
+/* randomly allocates and frees small blocks, keeping up to `B_NUMSLOTS` of
+ * them alive at any time
+ */
+static void* B_AllocWorker (void* p_worker_)
+{
+    B_Worker* p_worker = (B_Worker*) p_worker_;
+    void* slots[B_NUMSLOTS] = { NULL };
+    unsigned int seed = p_worker->seed;
+    for (int i = 0; i < B_NUMOPS; ++i)
+    {
+        unsigned int r = B_Random(&seed);
+        void** p_slot = slots + r % B_NUMSLOTS;
+        int size = 8 + (r >> 16) % 248;
+        if (*p_slot)
+        {
+            if (p_worker->libc) free(*p_slot);
+            else E_Free(*p_slot);
+            *p_slot = NULL;
+        }
+        else if (p_worker->libc) *p_slot = malloc(size);
+        else *p_slot = E_Malloc(size, B_AllocWorker);
+        if (*p_slot) *((byte*) *p_slot) = (byte) i; // touch the block
+    }
+    for (int i = 0; i < B_NUMSLOTS; ++i)
+    {
+        if (!slots[i]) continue;
+        if (p_worker->libc) free(slots[i]);
+        else E_Free(slots[i]);
+    }
+    return NULL;
+}
+
+static double B_RunWorkers (int numthreads, int libc)
+{
+    pthread_t threads[B_MAXTHREADS];
+    B_Worker workers[B_MAXTHREADS];
+    double start = B_Now();
+    for (int t = 0; t < numthreads; ++t)
+    {
+        B_Worker worker = { 0x9e3779b9u * (t + 1), libc };
+        workers[t] = worker;
+        pthread_create(threads + t, NULL, B_AllocWorker, workers + t);
+    }
+    for (int t = 0; t < numthreads; ++t) pthread_join(threads[t], NULL);
+    return B_Now() - start;
+}
+
+/* alloc/free stress test to see how the throughput scales with the number of
+ * threads, compared against the C standard library
+ */
+void B_AllocThreads (void)
+{
+    char name[64];
+    E_Init(64);
+    E_Concurrent(1);
+    for (int numthreads = 1; numthreads <= B_MAXTHREADS; numthreads <<= 1)
+    {
+        double ops = (double) numthreads * B_NUMOPS;
+        snprintf(name, sizeof(name), "E_Malloc/E_Free, %d thread(s)",
+                 numthreads);
+        B_Report(name, ops, B_RunWorkers(numthreads, 0));
+        snprintf(name, sizeof(name), "malloc/free, %d thread(s)", numthreads);
+        B_Report(name, ops, B_RunWorkers(numthreads, 1));
+    }
+    E_Concurrent(0);
+    if (E_Verify()) printf("B_AllocThreads: Corrupted zone!\n");
+    E_Destroy();
+}
+
+#define B_MATRIXSIZE 256
+#define B_NUMMULTS 8
+#define B_NUMROUNDS 3
+
+/* multiplies matrices that start at a cache line boundary, and ones that
+ * start 8 bytes past it, keeping the best of a few rounds for each. `M_Dot`
+ * reads the rows of the latter with unaligned loads
+ */
+void B_AlignedMult (void)
+{
+    const int n = B_MATRIXSIZE;
+    const size_t size = sizeof(double) * n * n;
+    E_Init(64);
+    byte* p_left = (byte*) E_MallocAligned(size + 64, 64, B_AlignedMult);
+    byte* p_right = (byte*) E_MallocAligned(size + 64, 64, B_AlignedMult);
+    double best[2] = { 0, 0 };
+    unsigned int seed = 42;
+    for (int round = 0; round < B_NUMROUNDS; ++round)
+    {
+        for (int offset = 0; offset <= 8; offset += 8)
+        {
+            double* left = (double*) (p_left + offset);
+            double* right = (double*) (p_right + offset);
+            for (int i = 0; i < n * n; ++i)
+            {
+                *(left + i) = (B_Random(&seed) & 0xffff) / 65536.0;
+                *(right + i) = (B_Random(&seed) & 0xffff) / 65536.0;
+            }
+            double start = B_Now();
+            for (int m = 0; m < B_NUMMULTS; ++m)
+                E_Free(M_Mult(left, n, n, right, n, n));
+            double elapsed = B_Now() - start;
+            double* p_best = best + (offset >> 3);
+            if (!round || elapsed < *p_best) *p_best = elapsed;
+        }
+    }
+    double ops = (double) B_NUMMULTS * n * n * n;
+    B_Report("M_Mult, aligned to a cache line", ops, best[0]);
+    B_Report("M_Mult, 8B off a cache line", ops, best[1]);
+    E_Free(p_left);
+    E_Free(p_right);
+    E_Destroy();
+}
+
+#define B_MINCOPY 16
+#define B_MAXCOPY (64 << 20)
+#define B_BYTESPERSIZE (256 << 20) // bytes moved for each size measured
+
+static const char* implnames[] = { "byte", "word", "SSE2", "AVX2" };
+
+/* copies `size` bytes over and over again, `B_BYTESPERSIZE` in total */
+static double B_Copy (byte* dest, byte* src, size_t size, int libc)
+{
+    size_t reps = B_BYTESPERSIZE / size;
+    double start = B_Now();
+    for (size_t r = 0; r < reps; ++r)
+    {
+        if (libc) memcpy(dest, src, size);
+        else E_Memcpy(dest, src, size);
+    }
+    return B_Now() - start;
+}
+
+static double B_Set (byte* dest, size_t size, int libc)
+{
+    size_t reps = B_BYTESPERSIZE / size;
+    double start = B_Now();
+    for (size_t r = 0; r < reps; ++r)
+    {
+        if (libc) memset(dest, (int) r, size);
+        else E_Memset(dest, (int) r, size);
+    }
+    return B_Now() - start;
+}
+
+/* copies and fills blocks of 16B to 64MiBs with each implementation of
+ * `E_Memcpy` and `E_Memset`, and with the C standard library; an op is a
+ * byte, so Mops/s reads as MB/s
+ */
+void B_Memcpy (void)
+{
+    char name[64];
+    E_Init(2 * B_MAXCOPY / (1 << 20) + 1);
+    byte* p_src = (byte*) E_MallocAligned(B_MAXCOPY, 64, B_Memcpy);
+    byte* p_dest = (byte*) E_MallocAligned(B_MAXCOPY, 64, B_Memcpy);
+    // fault the pages in before timing anything
+    memset(p_src, 0x5a, B_MAXCOPY);
+    memset(p_dest, 0, B_MAXCOPY);
+    for (size_t size = B_MINCOPY; size <= B_MAXCOPY; size <<= 2)
+    {
+        double bytes = (double) (B_BYTESPERSIZE / size) * size;
+        for (int impl = E_MEM_BYTE; impl <= E_MEM_AVX2; ++impl)
+        {
+            if (E_MemSelect(impl) < 0) continue;
+            snprintf(name, sizeof(name), "E_Memcpy (%s), %zuB",
+                     implnames[impl], size);
+            B_Report(name, bytes, B_Copy(p_dest, p_src, size, 0));
+            snprintf(name, sizeof(name), "E_Memset (%s), %zuB",
+                     implnames[impl], size);
+            B_Report(name, bytes, B_Set(p_dest, size, 0));
+        }
+        snprintf(name, sizeof(name), "memcpy, %zuB", size);
+        B_Report(name, bytes, B_Copy(p_dest, p_src, size, 1));
+        snprintf(name, sizeof(name), "memset, %zuB", size);
+        B_Report(name, bytes, B_Set(p_dest, size, 1));
+    }
+    E_MemSelect(E_MEM_AUTO);
+    E_Free(p_src);
+    E_Free(p_dest);
+    E_Destroy();
+}
+
+#define B_NUMNODES 4096
+#define B_NODESIZE 24 // e.g., an `AVL_Node`
+
+/* randomly allocates and frees node-sized objects, keeping up to `B_NUMNODES`
+ * of them alive at any time; `kind` is 0 for `E_Malloc`, 1 for `E_SlabAlloc`,
+ * and 2 for the C standard library
+ */
+static double B_Churn (E_Slab* p_slab, int kind)
+{
+    void** slots = (void**) E_Malloc(sizeof(void*) * B_NUMNODES, B_Churn);
+    for (int i = 0; i < B_NUMNODES; ++i) *(slots + i) = NULL;
+    unsigned int seed = 42;
+    double start = B_Now();
+    for (int i = 0; i < B_NUMOPS; ++i)
+    {
+        void** p_slot = slots + B_Random(&seed) % B_NUMNODES;
+        if (*p_slot)
+        {
+            if (kind == 0) E_Free(*p_slot);
+            else if (kind == 1) E_SlabFree(p_slab, *p_slot);
+            else free(*p_slot);
+            *p_slot = NULL;
+            continue;
+        }
+        if (kind == 0) *p_slot = E_Malloc(B_NODESIZE, B_Churn);
+        else if (kind == 1) *p_slot = E_SlabAlloc(p_slab);
+        else *p_slot = malloc(B_NODESIZE);
+        *((byte*) *p_slot) = (byte) i; // touch the object
+    }
+    double elapsed = B_Now() - start;
+    if (kind == 1) E_SlabDump(p_slab);
+    for (int i = 0; i < B_NUMNODES; ++i)
+    {
+        if (!*(slots + i)) continue;
+        if (kind == 0) E_Free(*(slots + i));
+        else if (kind == 1) E_SlabFree(p_slab, *(slots + i));
+        else free(*(slots + i));
+    }
+    E_Free(slots);
+    return elapsed;
+}
+
+/* node churn through `E_Malloc`, a slab, and the C standard library */
+void B_SlabChurn (void)
+{
+    char name[64];
+    E_Init(16);
+    E_Slab* p_slab = E_SlabCreate(B_NODESIZE);
+    printf("E_Malloc: %zuB per object\n",
+           sizeof(E_Memblock) + ((B_NODESIZE + 7) >> 3 << 3));
+    snprintf(name, sizeof(name), "E_Malloc/E_Free, %dB", B_NODESIZE);
+    B_Report(name, B_NUMOPS, B_Churn(p_slab, 0));
+    snprintf(name, sizeof(name), "E_SlabAlloc/E_SlabFree, %dB", B_NODESIZE);
+    B_Report(name, B_NUMOPS, B_Churn(p_slab, 1));
+    snprintf(name, sizeof(name), "malloc/free, %dB", B_NODESIZE);
+    B_Report(name, B_NUMOPS, B_Churn(p_slab, 2));
+    E_SlabDestroy(p_slab);
+    if (E_Verify()) printf("B_SlabChurn: Corrupted zone!\n");
+    E_Destroy();
+}
+
+#define B_FRAGZONEMIB 32
+#define B_FRAGSLOTS 4096
+#define B_FRAGOPS 400000
+#define B_FRAGSTEPS 10
+
+/* a mix of mostly small, some medium and a few big blocks, e.g., nodes,
+ * dynlist arrays and matrices
+ */
+static size_t B_FragSize (unsigned int r)
+{
+    unsigned int kind = r % 100;
+    r >>= 8;
+    if (kind < 85) return 16 + r % 240;
+    if (kind < 98) return 1024 + r % (15 * 1024);
+    return (64 << 10) + r % (960 << 10);
+}
+
+/* replays the mix on a zone that cannot grow, and reports the biggest block
+ * that can still be allocated as it goes
+ */
+void B_Fragmentation (void)
+{
+    E_Init(1);
+    E_Zone* p_zone = E_ZoneCreate(B_FRAGZONEMIB, 0);
+    void** slots = (void**) E_Malloc(sizeof(void*) * B_FRAGSLOTS,
+                                     B_Fragmentation);
+    size_t* sizes = (size_t*) E_Malloc(sizeof(size_t) * B_FRAGSLOTS,
+                                       B_Fragmentation);
+    for (int i = 0; i < B_FRAGSLOTS; ++i) { slots[i] = NULL; sizes[i] = 0; }
+    unsigned int seed = 42;
+    size_t live = 0, numfailed = 0;
+    printf("%10s %14s %14s %10s\n", "ops", "live (KiB)", "largest (KiB)",
+           "failed");
+    double start = B_Now();
+    for (int i = 1; i <= B_FRAGOPS; ++i)
+    {
+        unsigned int r = B_Random(&seed);
+        int slot = r % B_FRAGSLOTS;
+        if (slots[slot])
+        {
+            E_ZoneFree(p_zone, slots[slot]);
+            live -= sizes[slot];
+            slots[slot] = NULL;
+        }
+        else
+        {
+            size_t size = B_FragSize(B_Random(&seed));
+            // don't bother the zone with what it cannot hold
+            if (size > E_ZoneLargestFree(p_zone)) ++numfailed;
+            else
+            {
+                slots[slot] = E_ZoneMalloc(p_zone, size, B_Fragmentation);
+                sizes[slot] = size;
+                live += size;
+            }
+        }
+        if (i % (B_FRAGOPS / B_FRAGSTEPS)) continue;
+        printf("%10d %14zu %14zu %10zu\n", i, live >> 10,
+               E_ZoneLargestFree(p_zone) >> 10, numfailed);
+    }
+    B_Report("E_ZoneMalloc/E_ZoneFree, mixed", B_FRAGOPS, B_Now() - start);
+    if (E_ZoneVerify(p_zone)) printf("B_Fragmentation: Corrupted zone!\n");
+    E_ZoneDestroy(p_zone);
+    E_Free(slots);
+    E_Free(sizes);
+    E_Destroy();
+}
+
+/* an operation of the trace, with the pointers in it turned into the indices
+ * of the slots that hold the blocks during the replay
+ */
+typedef struct {
+    int op;
+    int slot;
+    int alignment; // log2
+    size_t size;
+} B_Op;
+
+/* maps the addresses of the live blocks in a trace to their slots, by open
+ * addressing
+ */
+typedef struct {
+    unsigned long long* keys; // 0 marks an empty entry
+    int* slots;
+    size_t mask;
+} B_AddrMap;
+
+static size_t B_AddrHash (B_AddrMap* p_map, unsigned long long key)
+{
+    return (key >> 4) * 0x9e3779b97f4a7c15ULL >> 17 & p_map->mask;
+}
+
+/* the entry that holds `key`, or the empty one where it would go */
+static size_t B_AddrFind (B_AddrMap* p_map, unsigned long long key)
+{
+    size_t i = B_AddrHash(p_map, key);
+    while (p_map->keys[i] && p_map->keys[i] != key) i = (i + 1) & p_map->mask;
+    return i;
+}
+
+/* removes the entry at `i`, shifting back the ones that probed past it */
+static void B_AddrRemove (B_AddrMap* p_map, size_t i)
+{
+    for (size_t j = (i + 1) & p_map->mask; p_map->keys[j];
+         j = (j + 1) & p_map->mask)
+    {
+        size_t home = B_AddrHash(p_map, p_map->keys[j]);
+        // leave the entry be if its home lies cyclically within (i, j]
+        if (((j - home) & p_map->mask) < ((j - i) & p_map->mask)) continue;
+        p_map->keys[i] = p_map->keys[j];
+        p_map->slots[i] = p_map->slots[j];
+        i = j;
+    }
+    p_map->keys[i] = 0;
+}
+
+static void B_Drop (B_Op* p_op, int slot)
+{
+    p_op->op = E_TRACE_FREE;
+    p_op->slot = slot;
+    p_op->alignment = 3;
+    p_op->size = 0;
+}
+
+/* turns the records into ops, handing each live block a slot of its own and
+ * re-using the slots of the blocks that are gone, returning the number of
+ * ops, and the number of slots needed in `p_numslots`
+ */
+static size_t B_Prepare (E_TraceRecord* records, size_t numrecords, B_Op* ops,
+                         int* p_numslots)
+{
+    B_AddrMap map;
+    map.mask = 1;
+    while (map.mask < numrecords * 2) map.mask <<= 1;
+    map.keys = (unsigned long long*) calloc(map.mask, sizeof(long long));
+    map.slots = (int*) malloc(sizeof(int) * map.mask);
+    int* freeslots = (int*) malloc(sizeof(int) * (numrecords + 1));
+    --map.mask;
+    size_t numops = 0;
+    int numfreeslots = 0, numslots = 0;
+    for (size_t r = 0; r < numrecords; ++r)
+    {
+        E_TraceRecord* p_record = records + r;
+        size_t i = p_record->ptr ? B_AddrFind(&map, p_record->ptr) : 0;
+        int known = p_record->ptr && map.keys[i];
+        if (p_record->op == E_TRACE_MOVE)
+        {
+            // a block moved by the allocator keeps its slot
+            if (!known) continue;
+            int slot = map.slots[i];
+            B_AddrRemove(&map, i);
+            i = B_AddrFind(&map, p_record->result);
+            map.keys[i] = p_record->result;
+            map.slots[i] = slot;
+            continue;
+        }
+        if (p_record->op == E_TRACE_FREE)
+        {
+            // frees of blocks that are not in the trace are skipped
+            if (!known) continue;
+            B_Drop(ops + numops++, map.slots[i]);
+            freeslots[numfreeslots++] = map.slots[i];
+            B_AddrRemove(&map, i);
+            continue;
+        }
+        // failed calls leave nothing behind to replay
+        if (!p_record->result) continue;
+        int slot;
+        if (p_record->op == E_TRACE_REALLOC && known)
+        {
+            slot = map.slots[i];
+            B_AddrRemove(&map, i);
+        }
+        else slot = numfreeslots ? freeslots[--numfreeslots] : numslots++;
+        /* a block handed out at the address of a live one means the zone
+         * it was in has been destroyed since, so drop the stale one
+         */
+        i = B_AddrFind(&map, p_record->result);
+        if (map.keys[i])
+        {
+            B_Drop(ops + numops++, map.slots[i]);
+            freeslots[numfreeslots++] = map.slots[i];
+            B_AddrRemove(&map, i);
+            i = B_AddrFind(&map, p_record->result);
+        }
+        map.keys[i] = p_record->result;
+        map.slots[i] = slot;
+        // a realloc of a block unknown to the trace is replayed as a malloc
+        ops[numops].op = p_record->op == E_TRACE_REALLOC && known ?
+                         E_TRACE_REALLOC : E_TRACE_MALLOC;
+        ops[numops].slot = slot;
+        ops[numops].alignment = p_record->alignment;
+        ops[numops++].size = p_record->size;
+    }
+    free(map.keys);
+    free(map.slots);
+    free(freeslots);
+    *p_numslots = numslots;
+    return numops;
+}
+
+/* runs a single op, on `p_zone` or on the C standard library if NULL */
+static void B_Run (B_Op* p_op, void** slots, E_Zone* p_zone)
+{
+    void** p_slot = slots + p_op->slot;
+    size_t alignment = (size_t) 1 << p_op->alignment;
+    switch (p_op->op)
+    {
+        case E_TRACE_MALLOC:
+            if (p_zone)
+                *p_slot = p_op->alignment > 3 ?
+                          E_ZoneMallocAligned(p_zone, p_op->size, alignment,
+                                              B_Run) :
+                          E_ZoneMalloc(p_zone, p_op->size, B_Run);
+            else if (p_op->alignment <= 3) *p_slot = malloc(p_op->size);
+            else if (posix_memalign(p_slot, alignment, p_op->size))
+                *p_slot = NULL;
+            break;
+        case E_TRACE_REALLOC:
+            // the C standard library cannot keep the alignment on realloc,
+            // which is close enough for the sake of timing
+            if (!*p_slot) break;
+            if (!p_zone) *p_slot = realloc(*p_slot, p_op->size);
+            else if (p_op->alignment > 3)
+                *p_slot = E_ZoneReallocAligned(p_zone, *p_slot, p_op->size,
+                                               alignment);
+            else *p_slot = E_ZoneRealloc(p_zone, *p_slot, p_op->size);
+            break;
+        default:
+            if (p_zone) E_ZoneFree(p_zone, *p_slot);
+            else free(*p_slot);
+            *p_slot = NULL;
+            return;
+    }
+    if (*p_slot && p_op->size) *((byte*) *p_slot) = 1; // touch the block
+}
+
+/* the bytes the C standard library has taken from the system, and of those,
+ * the ones in use
+ */
+static void B_LibcStats (E_Stats* p_stats)
+{
+    E_Memset(p_stats, 0, sizeof(E_Stats));
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    p_stats->mapped = info.arena + info.hblkhd;
+    p_stats->used = info.uordblks + info.hblkhd;
+    p_stats->free = info.fordblks;
+#endif
+}
+
+/* replays the ops on `p_zone`, or on the C standard library if NULL, timing
+ * them if `p_peak` is NULL, otherwise sampling the footprint as it goes and
+ * keeping the one where the most is in use in `p_peak`
+ */
+static double B_Replay_ (B_Op* ops, size_t numops, int numslots,
+                         E_Zone* p_zone, E_Stats* p_peak)
+{
+    void** slots = (void**) calloc(numslots ? numslots : 1, sizeof(void*));
+    size_t step = numops / 1024 ? numops / 1024 : 1;
+    E_Stats base, stats;
+    if (p_peak) B_LibcStats(&base);
+    double start = B_Now();
+    for (size_t i = 0; i < numops; ++i)
+    {
+        B_Run(ops + i, slots, p_zone);
+        if (!p_peak || ((i + 1) % step && i + 1 < numops)) continue;
+        if (p_zone) E_ZoneGetStats(p_zone, &stats);
+        else
+        {
+            B_LibcStats(&stats);
+            stats.mapped = stats.mapped > base.mapped ?
+                           stats.mapped - base.mapped : 0;
+            stats.used = stats.used > base.used ? stats.used - base.used : 0;
+        }
+        if (stats.used >= p_peak->used) *p_peak = stats;
+    }
+    double seconds = B_Now() - start;
+    for (int i = 0; i < numslots; ++i)
+    {
+        if (!slots[i]) continue;
+        if (p_zone) E_ZoneFree(p_zone, slots[i]);
+        else free(slots[i]);
+    }
+    free(slots);
+    return seconds;
+}
+
+/* replays the trace recorded at `path` with `E_TraceStart`, on a zone of its
+ * own and on the C standard library, and reports the throughput and the
+ * footprint of each
+ */
+int B_Replay (const char* path)
+{
+    FILE* p_file = fopen(path, "rb");
+    if (!p_file)
+    {
+        printf("B_Replay: Could not open %s.\n", path);
+        return 1;
+    }
+    fseek(p_file, 0, SEEK_END);
+    size_t numrecords = ftell(p_file) / sizeof(E_TraceRecord);
+    fseek(p_file, 0, SEEK_SET);
+    E_TraceRecord* records = (E_TraceRecord*)
+                             malloc(sizeof(E_TraceRecord) * (numrecords + 1));
+    numrecords = fread(records, sizeof(E_TraceRecord), numrecords, p_file);
+    fclose(p_file);
+    // a drop may be added for each record, along with the record itself
+    B_Op* ops = (B_Op*) malloc(sizeof(B_Op) * (numrecords * 2 + 1));
+    int numslots;
+    size_t numops = B_Prepare(records, numrecords, ops, &numslots);
+    free(records);
+    printf("%zu records, %zu ops, up to %d blocks live\n", numrecords, numops,
+           numslots);
+    const char* names[] = { "E_ZoneMalloc et al.", "malloc et al." };
+    E_Stats peaks[2];
+    for (int libc = 0; libc < 2; ++libc)
+    {
+        /* sample the footprint first, while the caches of the C standard
+         * library are still cold, then replay the ops once more, on a fresh
+         * zone, for timing, as sampling is too slow to do along with it
+         */
+        E_Zone* p_zone = libc ? NULL : E_ZoneCreate(1, E_ZONE_GROWABLE);
+        E_Memset(peaks + libc, 0, sizeof(E_Stats));
+        B_Replay_(ops, numops, numslots, p_zone, peaks + libc);
+        if (p_zone) E_ZoneDestroy(p_zone);
+        p_zone = libc ? NULL : E_ZoneCreate(1, E_ZONE_GROWABLE);
+        B_Report(names[libc], numops,
+                 B_Replay_(ops, numops, numslots, p_zone, NULL));
+        if (p_zone) E_ZoneDestroy(p_zone);
+    }
+    free(ops);
+    printf("%-20s %14s %14s %14s\n", "", "mapped (KiB)", "used (KiB)",
+           "fragmentation");
+    for (int libc = 0; libc < 2; ++libc)
+    {
+        E_Stats* p_peak = peaks + libc;
+        printf("%-20s %14zu %14zu ", names[libc], p_peak->mapped >> 10,
+               p_peak->used >> 10);
+        // how much of the free memory cannot be handed out as a single block
+        if (libc || !p_peak->free) printf("%14s\n", "-");
+        else printf("%13.1f%%\n",
+                    100.0 * (1.0 - (double) p_peak->largestfree /
+                                   p_peak->free));
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ *  b_emalloc.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Benchmarks for the custom memory allocator.
+ *
+ *      `B_Replay` replays a trace recorded with `E_TraceStart` on both the
+ *      custom allocator and the C standard library.
+ */
+
+#ifndef b_emalloc_h
+
+#define b_emalloc_h
+#define b_emalloc_h_B_AllocThreads B_AllocThreads
+#define b_emalloc_h_B_AlignedMult B_AlignedMult
+#define b_emalloc_h_B_Memcpy B_Memcpy
+#define b_emalloc_h_B_SlabChurn B_SlabChurn
+#define b_emalloc_h_B_Fragmentation B_Fragmentation
+#define b_emalloc_h_B_Replay B_Replay
+
+void B_AllocThreads (void);
+void B_AlignedMult (void);
+void B_Memcpy (void);
+void B_SlabChurn (void);
+void B_Fragmentation (void);
+int B_Replay (const char* path);
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ *  b_heap.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Benchmarks for the heaps.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "e_malloc.h"
+#include "h_heap.h"
+#include "b_bench.h"
+
+#define B_MINNODES 1000000
+#define B_MAXNODES 100000000
+#define B_NUMQUEUED 1000000
+
+/* the way `H_Heapify` used to be, kept around to compare against: bubble
+ * each node up as it's copied over, finding the parents in floating point
+ */
+static int B_OldParent (int index)
+{
+    return ceil((index * 0.5) - 1);
+}
+
+static void B_OldHeapify (HeapNode* raw, HeapNode* heap, int size)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        *(heap + i) = *(raw + i);
+        int key = (heap + i)->key;
+        int self = i, parent = B_OldParent(self);
+        while (parent >= 0 && (heap + parent)->key < key)
+        {
+            HeapNode aux = *(heap + parent);
+            *(heap + parent) = *(heap + self);
+            *(heap + self) = aux;
+            self = parent;
+            parent = B_OldParent(self);
+        }
+    }
+}
+
+static int B_IsHeap (HeapNode* heap, int size)
+{
+    for (int i = 1; i < size; ++i)
+        if ((heap + ((i - 1) >> 1))->key < (heap + i)->key) return 0;
+    return 1;
+}
+
+/* builds heaps of random keys of growing sizes, the old way, bottom-up into
+ * a second array, and bottom-up in place
+ */
+void B_Heapify (void)
+{
+    static const char* names[] = { "H_Heapify (old)", "H_Heapify",
+                                   "H_HeapifyInPlace" };
+    E_Init(1);
+    HeapNode* raw = (HeapNode*) E_Malloc(sizeof(HeapNode) * B_MAXNODES,
+                                         B_Heapify);
+    HeapNode* heap = (HeapNode*) E_Malloc(sizeof(HeapNode) * B_MAXNODES,
+                                          B_Heapify);
+    char name[64];
+    for (int size = B_MINNODES; size <= B_MAXNODES; size *= 10)
+    {
+        for (int kind = 0; kind < 3; ++kind)
+        {
+            unsigned int seed = 42;
+            for (int i = 0; i < size; ++i)
+            {
+                (raw + i)->data = i;
+                (raw + i)->key = B_Random(&seed);
+            }
+            double start = B_Now();
+            if (kind == 0) B_OldHeapify(raw, heap, size);
+            else if (kind == 1) H_Heapify(raw, heap, size);
+            else H_HeapifyInPlace(raw, size);
+            double seconds = B_Now() - start;
+            sprintf(name, "%s, %d nodes", names[kind], size);
+            B_Report(name, size, seconds);
+            if (!B_IsHeap(kind == 2 ? raw : heap, size))
+                printf("B_Heapify: %s is not a heap.\n", names[kind]);
+        }
+    }
+    E_Free(heap);
+    E_Free(raw);
+    E_Destroy();
+}
+
+/* pushes random keys into a queue that starts out small, changes the key of
+ * each node once, the way Dijkstra's algorithm would, and pops them all
+ */
+void B_HeapQueue (void)
+{
+    E_Init(1);
+    int* handles = (int*) E_Malloc(sizeof(int) * B_NUMQUEUED, B_HeapQueue);
+    H_Queue* p_queue = H_QueueInit(0);
+    unsigned int seed = 42;
+    double start = B_Now();
+    for (int i = 0; i < B_NUMQUEUED; ++i)
+        handles[i] = H_Push(p_queue, i, B_Random(&seed) >> 1);
+    B_Report("H_Push", B_NUMQUEUED, B_Now() - start);
+    start = B_Now();
+    for (int i = 0; i < B_NUMQUEUED; ++i)
+        H_UpdateKey(p_queue, handles[B_Random(&seed) % B_NUMQUEUED],
+                    B_Random(&seed) >> 1);
+    B_Report("H_UpdateKey", B_NUMQUEUED, B_Now() - start);
+    start = B_Now();
+    int last = H_Peek(p_queue)->key, sorted = 1;
+    while (p_queue->size)
+    {
+        int key = H_Pop(p_queue).key;
+        if (key > last) sorted = 0;
+        last = key;
+    }
+    B_Report("H_Pop", B_NUMQUEUED, B_Now() - start);
+    if (!sorted) printf("B_HeapQueue: The keys came out of order.\n");
+    H_QueueDestroy(p_queue);
+    E_Free(handles);
+    E_Destroy();
+}
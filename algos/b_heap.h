@@ -0,0 +1,20 @@
+/*
+ *  b_heap.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Benchmarks for the heaps.
+ */
+
+#ifndef b_heap_h
+
+#define b_heap_h
+#define b_heap_h_B_Heapify B_Heapify
+#define b_heap_h_B_HeapQueue B_HeapQueue
+
+void B_Heapify (void);
+void B_HeapQueue (void);
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ *  e_arena.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      A stack-style scratch arena for temporaries, built on top of the custom
+ *      memory allocator.
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include "t_typedef.h"
+#include "e_malloc.h"
+#include "e_arena.h"
+
+// the least amount of memory each block of the arena holds
+#define E_ARENABLOCK (64 * 1024)
+
+typedef struct arenablock {
+    struct arenablock* p_prev; // the block below, NULL if the bottom
+    size_t size, top;
+} E_ArenaBlock;
+
+static const size_t SIZE_ARENAHEADER = (sizeof(E_ArenaBlock) + 7) >> 3 << 3;
+
+typedef struct {
+    E_ArenaBlock* p_top;
+    int nummarks;
+    int generation; // the generation of the zone the blocks came from
+} E_Arena;
+
+static __thread E_Arena arena;
+static pthread_key_t arenakey;
+static pthread_once_t arenakeyonce = PTHREAD_ONCE_INIT;
+
+/* gives the blocks of the arena back when a thread exits */
+static void E_ArenaExit (void* p_arena)
+{
+    (void) p_arena;
+    E_ArenaDestroy();
+}
+
+static void E_ArenaInitKey (void)
+{
+    pthread_key_create(&arenakey, E_ArenaExit);
+}
+
+/* pushes a new block that can hold at least `size` bytes */
+static E_ArenaBlock* E_ArenaPush (size_t size)
+{
+    if (size < E_ARENABLOCK) size = E_ARENABLOCK;
+    E_ArenaBlock* p_block =
+        (E_ArenaBlock*) E_Malloc(SIZE_ARENAHEADER + size, E_ArenaPush);
+    if (!p_block) return NULL;
+    if (!arena.p_top)
+    {
+        arena.generation = E_Generation();
+        // register the arena to be destroyed once the thread exits
+        pthread_once(&arenakeyonce, E_ArenaInitKey);
+        pthread_setspecific(arenakey, &arena);
+    }
+    p_block->p_prev = arena.p_top;
+    p_block->size = size;
+    p_block->top = 0;
+    arena.p_top = p_block;
+    return p_block;
+}
+
+E_ArenaMark_t E_ArenaMark (void)
+{
+    // drop the bottom block if it went away along with an older default zone
+    if (!arena.nummarks && arena.generation != E_Generation())
+        arena.p_top = NULL;
+    if (!arena.p_top) E_ArenaPush(0);
+    ++arena.nummarks;
+    E_ArenaMark_t mark = { arena.p_top, arena.p_top ? arena.p_top->top : 0 };
+    return mark;
+}
+
+void* E_ArenaAllocAligned (size_t size, size_t alignment)
+{
+    if (!arena.nummarks)
+    {
+        printf("E_ArenaAlloc: No mark has been taken.\n");
+        return NULL;
+    }
+    if (alignment < 8) alignment = 8;
+    if (alignment & (alignment - 1))
+    {
+        printf("E_ArenaAlloc: Alignment of %zuBs is not a power of 2.\n",
+               alignment);
+        return NULL;
+    }
+    /* bump the top, or move on to a new block if it does not fit */
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        E_ArenaBlock* p_block = arena.p_top;
+        if (p_block)
+        {
+            size_t base = (size_t) p_block + SIZE_ARENAHEADER;
+            size_t start = (base + p_block->top + alignment - 1) &
+                           ~(alignment - 1);
+            if (start + size <= base + p_block->size)
+            {
+                p_block->top = start + size - base;
+                return (void*) start;
+            }
+        }
+        if (!attempt && !E_ArenaPush(size + alignment)) break;
+    }
+    printf("E_ArenaAlloc: Insufficient memory for %zuBs.\n", size);
+    return NULL;
+}
+
+void* E_ArenaAlloc (size_t size)
+{
+    return E_ArenaAllocAligned(size, 8);
+}
+
+/* drops everything allocated since `mark`, along with the blocks pushed
+ * since–the bottom block stays, to be reused by the next mark
+ */
+void E_ArenaRelease (E_ArenaMark_t mark)
+{
+    if (!arena.nummarks)
+    {
+        printf("E_ArenaRelease: No mark has been taken.\n");
+        return;
+    }
+    while (arena.p_top && arena.p_top != mark.p_block)
+    {
+        E_ArenaBlock* p_prev = arena.p_top->p_prev;
+        E_Free(arena.p_top);
+        arena.p_top = p_prev;
+    }
+    if (arena.p_top) arena.p_top->top = mark.top;
+    --arena.nummarks;
+}
+
+/* gives the blocks of the arena of the calling thread back to the allocator,
+ * which happens on its own once the thread exits
+ */
+void E_ArenaDestroy (void)
+{
+    if (arena.nummarks)
+    {
+        printf("E_ArenaDestroy: %d mark(s) have not been released.\n",
+               arena.nummarks);
+        return;
+    }
+    // the blocks of an older default zone are already gone
+    if (arena.generation != E_Generation()) arena.p_top = NULL;
+    while (arena.p_top)
+    {
+        E_ArenaBlock* p_prev = arena.p_top->p_prev;
+        E_Free(arena.p_top);
+        arena.p_top = p_prev;
+    }
+}
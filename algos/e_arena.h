@@ -0,0 +1,49 @@
+/*
+ *  e_arena.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      A stack-style scratch arena for temporaries, built on top of the custom
+ *      memory allocator.
+ *
+ *      `E_ArenaMark` remembers the top of the arena, `E_ArenaAlloc` bumps it,
+ *      and `E_ArenaRelease` drops everything allocated since the mark at once.
+ *      Marks nest, and have to be released in the reverse order they were
+ *      taken.
+ *
+ *      The arena is backed by a single block from `E_Malloc`, and by a few more
+ *      only when that one overflows. The bottom block is taken when the first
+ *      mark is, and kept once the last one is released, so that a mark costs
+ *      no more than a pointer bump. It is given back by `E_ArenaDestroy`, or
+ *      when the thread exits, and simply forgotten if the default zone is
+ *      destroyed along with it.
+ *
+ *      Each thread has an arena of its own.
+ */
+
+#ifndef e_arena_h
+
+#include "t_typedef.h"
+
+#define e_arena_h
+#define e_arena_h_E_ArenaMark_t E_ArenaMark_t
+#define e_arena_h_E_ArenaMark E_ArenaMark
+#define e_arena_h_E_ArenaAlloc E_ArenaAlloc
+#define e_arena_h_E_ArenaAllocAligned E_ArenaAllocAligned
+#define e_arena_h_E_ArenaRelease E_ArenaRelease
+#define e_arena_h_E_ArenaDestroy E_ArenaDestroy
+
+typedef struct {
+    void* p_block; // the block that was on top when the mark was taken
+    size_t top; // the offset of the top in that block
+} E_ArenaMark_t;
+
+E_ArenaMark_t E_ArenaMark (void);
+void* E_ArenaAlloc (size_t size);
+void* E_ArenaAllocAligned (size_t size, size_t alignment);
+void E_ArenaRelease (E_ArenaMark_t mark);
+void E_ArenaDestroy (void);
+
+#endif
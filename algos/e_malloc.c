@@ -8,9 +8,10 @@
  *      My very own custom memory allocator. (The prefix 'E' stands for 'Emre'–
  *      I know, I know...)
  *
- *      Exposes a single memory zone available for allocation. There is never
- *      any space between memory blocks, and there will never be two contiguous
- *      free memory blocks.
+ *      Exposes a default memory zone available for allocation, and as many
+ *      independent zones as needed on top of it. There is never any space
+ *      between memory blocks, and there will never be two contiguous free
+ *      memory blocks.
  *
  *  TODO:
  *      - Add descriptions for "public" functions
@@ -18,250 +19,1704 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
 
 #include "e_malloc.h"
 
-static const int E_TAG = 1;
-static const int SIZE_HEADER = sizeof(E_Memblock);
+// marks the headers initialized by `E_Malloc`
+static const unsigned int E_MAGIC = 0xe3a110c8;
+// the tag of the free blocks
+#define E_TAG_FREE 0
+static const size_t SIZE_HEADER = sizeof(E_Memblock);
 
-E_Memblock* p_mainmemory = NULL;
-E_Memblock* p_rover = NULL;
+/* free blocks smaller than `E_SMALLMAX` are kept in exact-size bins, 8 bytes
+ * apart, while each power of two above is split into `E_NUMSUBBINS` bins of
+ * equal width (as in TLSF), so that the blocks in a bin are never more than an
+ * eighth apart in size
+ */
+#define E_NUMSMALLBINS 32
+#define E_SMALLMAX (E_NUMSMALLBINS << 3)
+#define E_SMALLMAXLOG2 8
+#define E_SUBBINSLOG2 3
+#define E_NUMSUBBINS (1 << E_SUBBINSLOG2)
+#define E_NUMBINS ((int) (E_NUMSMALLBINS + \
+                          ((sizeof(size_t) << 3) - E_SMALLMAXLOG2) * \
+                          E_NUMSUBBINS))
+// the bin map is a bitmap of the non-empty bins, with a bitmap of the
+// non-empty words of it on top
+#define E_NUMBINWORDS ((E_NUMBINS + 63) >> 6)
+
+#define E_HUGEPAGE (2 * 1024 * 1024)
+
+/* a zone grows by twice as much every time, so this many chunks are more than
+ * the address space can hold
+ */
+#define E_MAXCHUNKS 48
+
+// the number of recently touched blocks remembered for `E_VerifyRecent`
+#define E_NUMRECENT 32
+
+/* the handles of the movable blocks live in pages mapped from the system
+ * apart from the zone, so that they never stand in the way of compaction
+ */
+#define E_HANDLEPAGE 4096
+
+struct handle {
+    void* ptr; // the payload of the block, NULL once freed
+    E_Zone* p_zone;
+    int locks; // the block can be moved only while this is 0
+    struct handle* p_nextfree;
+};
 
-static void E_InitBlock (E_Memblock* p_block, int size, void* owner, int tag,
-                         E_Memblock* p_prev, E_Memblock* p_next)
+typedef struct handlepage {
+    size_t size; // the size of the entire mapping
+    struct handlepage* p_next;
+} E_HandlePage;
+
+/* a zone is made up of one or more chunks of memory mapped from the system,
+ * each of which has its own list of memory blocks
+ */
+typedef struct chunk {
+    size_t size; // the size of the entire mapping, header included
+    struct chunk* p_next;
+    E_Memblock* p_memory; // the head of the list of memory blocks
+} E_Chunk;
+
+struct zone {
+    E_Chunk* p_chunks;
+    // the same chunks, sorted by their addresses, for `E_FindChunk`
+    E_Chunk* chunks[E_MAXCHUNKS];
+    int numchunks;
+    size_t chunksize; // the least amount of memory to grow by
+    int flags;
+    E_Memblock* p_bins[E_NUMBINS];
+    // a set bit marks a non-empty bin, or a non-empty word of `binmap`
+    unsigned long long binmap[E_NUMBINWORDS];
+    unsigned long long binsummary;
+    // number of reallocs in total, and those that did not need to move the
+    // block
+    int numreallocs, numinplace;
+    // a ring of the blocks touched lately, kept only while tracking
+    E_Memblock* p_recent[E_NUMRECENT];
+    int nextrecent, tracking;
+    // where `E_VerifyStep` left off
+    E_Chunk* p_cursorchunk;
+    E_Memblock* p_cursor;
+    E_HandlePage* p_handlepages;
+    E_Handle* p_freehandles;
+    pthread_mutex_t lock;
+};
+
+static const size_t SIZE_CHUNK = (sizeof(E_Chunk) + 7) >> 3 << 3;
+static const size_t SIZE_ZONE = (sizeof(E_Zone) + 7) >> 3 << 3;
+static const size_t SIZE_HANDLEPAGE = (sizeof(E_HandlePage) + 7) >> 3 << 3;
+
+// the zone that backs `E_Malloc`, `E_Free` and the like
+static E_Zone* p_defaultzone = NULL;
+
+static void E_InitBlock (E_Memblock* p_block, size_t size, void* owner,
+                         int tag, E_Memblock* p_prev, E_Memblock* p_next)
 {
     p_block->size = size;
     p_block->owner = owner;
     p_block->tag = tag;
+    p_block->magic = E_MAGIC;
     p_block->p_prev = p_prev;
     p_block->p_next = p_next;
 }
 
-void E_Init (int sizemib)
+static int E_BinIndex (size_t size)
 {
-    int size = sizemib * 1024 * 1024 + SIZE_HEADER;
-    // allocate an entire contiguous block of memory for our custom allocator
-    // to manage
-    E_Memblock* p_memhead = (E_Memblock*) ((byte*) malloc(size));
-    // initialize the list of memory blocks
-    E_InitBlock(p_memhead, size - SIZE_HEADER, NULL, E_TAG, NULL, NULL);
-    p_mainmemory = p_memhead;
-    // initialize the rover to point to the head of the memory blocks
-    p_rover = p_mainmemory;
+    if (size < E_SMALLMAX) return size >> 3;
+    // the index of the most significant bit, i.e., `floor(log2(size))`
+    int msb = (sizeof(size_t) << 3) - 1 - __builtin_clzl(size);
+    // the bits right below it pick the sub-bin
+    int sub = (size >> (msb - E_SUBBINSLOG2)) & (E_NUMSUBBINS - 1);
+    return E_NUMSMALLBINS + ((msb - E_SMALLMAXLOG2) << E_SUBBINSLOG2) + sub;
 }
 
-void E_Destroy (void)
+static int E_BinMapped (E_Zone* p_zone, int bin)
 {
-    for (E_Memblock* p_current = p_mainmemory; p_current;
-         p_current = p_current->p_next)
-        if (p_current->owner)
-            E_Free((byte*) p_current + SIZE_HEADER);
-    free((byte*) p_mainmemory);
-    p_mainmemory = NULL; p_rover = NULL;
+    return (p_zone->binmap[bin >> 6] >> (bin & 63)) & 1;
+}
+
+/* returns the first non-empty bin from `bin` on, or -1 if there's none */
+static int E_BinNext (E_Zone* p_zone, int bin)
+{
+    if (bin >= E_NUMBINS) return -1;
+    int word = bin >> 6;
+    unsigned long long bits = p_zone->binmap[word] & (~0ULL << (bin & 63));
+    if (bits) return (word << 6) + __builtin_ctzll(bits);
+    if (word + 1 == E_NUMBINWORDS) return -1;
+    unsigned long long words = p_zone->binsummary & (~0ULL << (word + 1));
+    if (!words) return -1;
+    word = __builtin_ctzll(words);
+    return (word << 6) + __builtin_ctzll(p_zone->binmap[word]);
+}
+
+static void E_BinInsert (E_Zone* p_zone, E_Memblock* p_block)
+{
+    int bin = E_BinIndex(p_block->size);
+    E_Memblock* p_head = p_zone->p_bins[bin];
+    p_block->p_prevfree = NULL;
+    p_block->p_nextfree = p_head;
+    if (p_head) p_head->p_prevfree = p_block;
+    p_zone->p_bins[bin] = p_block;
+    p_zone->binmap[bin >> 6] |= 1ULL << (bin & 63);
+    p_zone->binsummary |= 1ULL << (bin >> 6);
+}
+
+static void E_BinRemove (E_Zone* p_zone, E_Memblock* p_block)
+{
+    int bin = E_BinIndex(p_block->size);
+    E_Memblock* p_prevfree = p_block->p_prevfree;
+    E_Memblock* p_nextfree = p_block->p_nextfree;
+    if (p_prevfree) p_prevfree->p_nextfree = p_nextfree;
+    else p_zone->p_bins[bin] = p_nextfree;
+    if (p_nextfree) p_nextfree->p_prevfree = p_prevfree;
+    if (p_zone->p_bins[bin]) return;
+    p_zone->binmap[bin >> 6] &= ~(1ULL << (bin & 63));
+    if (!p_zone->binmap[bin >> 6]) p_zone->binsummary &= ~(1ULL << (bin >> 6));
+}
+
+/* remembers a block that has just been allocated, freed or resized */
+static void E_Touch (E_Zone* p_zone, E_Memblock* p_block)
+{
+    if (!p_zone->tracking) return;
+    p_zone->p_recent[p_zone->nextrecent] = p_block;
+    p_zone->nextrecent = (p_zone->nextrecent + 1) % E_NUMRECENT;
+}
+
+/* lets go of a block header that has been merged into `p_survivor`, so that
+ * neither the ring nor the cursor is left pointing into the middle of a block
+ */
+static void E_Forget (E_Zone* p_zone, E_Memblock* p_gone,
+                      E_Memblock* p_survivor)
+{
+    if (p_zone->p_cursor == p_gone) p_zone->p_cursor = p_survivor;
+    if (!p_zone->tracking) return;
+    for (int i = 0; i < E_NUMRECENT; ++i)
+        if (p_zone->p_recent[i] == p_gone) p_zone->p_recent[i] = p_survivor;
+}
+
+/* finds a free block that can hold at least `size` bytes, in O(1) for small
+ * sizes
+ *
+ * big blocks are best-fit: the smallest one that fits from the bin of `size`,
+ * or else any one from the next non-empty bin, which is at most an eighth
+ * bigger than the smallest there–rather than splitting the first big block
+ * that comes along, and leaving none for the big requests to come
+ */
+static E_Memblock* E_BinFind (E_Zone* p_zone, size_t size)
+{
+    int bin = E_BinIndex(size);
+    /* every block in an exact-size bin fits, whereas the blocks in a sub-bin
+     * need to be looked at one by one
+     */
+    if (bin < E_NUMSMALLBINS)
+    {
+        if (p_zone->p_bins[bin]) return p_zone->p_bins[bin];
+    }
+    else
+    {
+        E_Memblock* p_best = NULL;
+        for (E_Memblock* p_current = p_zone->p_bins[bin]; p_current;
+             p_current = p_current->p_nextfree)
+        {
+            if (p_current->size < size) continue;
+            if (!p_best || p_current->size < p_best->size) p_best = p_current;
+            if (p_best->size == size) break;
+        }
+        if (p_best) return p_best;
+    }
+    /* any block in a bigger bin fits, so pick from the first non-empty one */
+    int bigger = E_BinNext(p_zone, bin + 1);
+    return bigger < 0 ? NULL : p_zone->p_bins[bigger];
+}
+
+/* the size of the biggest free block, i.e., the most that can be allocated
+ * without growing the zone
+ */
+static size_t E_LargestFree_ (E_Zone* p_zone)
+{
+    int bin = -1;
+    for (int word = E_NUMBINWORDS - 1; word >= 0 && bin < 0; --word)
+        if (p_zone->binmap[word])
+            bin = (word << 6) + 63 - __builtin_clzll(p_zone->binmap[word]);
+    if (bin < 0) return 0;
+    size_t largest = 0;
+    for (E_Memblock* p_current = p_zone->p_bins[bin]; p_current;
+         p_current = p_current->p_nextfree)
+        if (p_current->size > largest) largest = p_current->size;
+    return largest;
+}
+
+/* maps at least `size` bytes from the system, backed by huge pages if asked
+ * for and available
+ */
+static void* E_Map (size_t* p_size, int flags)
+{
+    size_t pagesize = sysconf(_SC_PAGESIZE);
+    size_t size = (*p_size + pagesize - 1) / pagesize * pagesize;
+    void* ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (flags & E_ZONE_HUGEPAGES)
+    {
+        size_t hugesize = (size + E_HUGEPAGE - 1) / E_HUGEPAGE * E_HUGEPAGE;
+        ptr = mmap(NULL, hugesize, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) size = hugesize;
+    }
+#endif
+    /* fall back to regular pages, and let the kernel know that we'd rather
+     * have huge pages, if that's what was asked for
+     */
+    if (ptr == MAP_FAILED)
+    {
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+        if (flags & E_ZONE_HUGEPAGES) madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    }
+    *p_size = size;
+    return ptr;
+}
+
+/* initializes a chunk of `size` bytes with a single free block that spans
+ * the memory left after the first `offset` bytes
+ */
+static E_Chunk* E_InitChunk (void* ptr, size_t size, size_t offset)
+{
+    E_Chunk* p_chunk = (E_Chunk*) ptr;
+    E_Memblock* p_memhead = (E_Memblock*) ((byte*) ptr + offset);
+    E_InitBlock(p_memhead, size - offset - SIZE_HEADER, NULL, E_TAG_FREE,
+                NULL, NULL);
+    p_chunk->size = size;
+    p_chunk->p_next = NULL;
+    p_chunk->p_memory = p_memhead;
+    return p_chunk;
+}
+
+/* extends the zone with a new chunk that can hold at least `size` bytes */
+static int E_Grow (E_Zone* p_zone, size_t size)
+{
+    if (p_zone->numchunks == E_MAXCHUNKS) return 0;
+    size_t chunksize = SIZE_CHUNK + SIZE_HEADER + size;
+    if (chunksize < p_zone->chunksize) chunksize = p_zone->chunksize;
+    void* ptr = E_Map(&chunksize, p_zone->flags);
+    if (!ptr) return 0;
+    E_Chunk* p_chunk = E_InitChunk(ptr, chunksize, SIZE_CHUNK);
+    /* link the chunk right after the first one, which hosts the zone */
+    p_chunk->p_next = p_zone->p_chunks->p_next;
+    p_zone->p_chunks->p_next = p_chunk;
+    /* and slot it in among the others by its address */
+    int i = p_zone->numchunks++;
+    for (; i > 0 && p_zone->chunks[i - 1] > p_chunk; --i)
+        p_zone->chunks[i] = p_zone->chunks[i - 1];
+    p_zone->chunks[i] = p_chunk;
+    E_BinInsert(p_zone, p_chunk->p_memory);
+    // grow geometrically, so that a zone never has more than a few chunks
+    p_zone->chunksize <<= 1;
+    return 1;
 }
 
-void* E_Malloc (int size, void* requester)
+/* the chunk that `ptr` lies in, or NULL if it's not in the zone, found by a
+ * binary search over the chunks sorted by their addresses
+ */
+static E_Chunk* E_FindChunk (E_Zone* p_zone, void* ptr)
+{
+    int lo = 0, hi = p_zone->numchunks;
+    while (hi - lo > 1)
+    {
+        int mid = (lo + hi) >> 1;
+        if ((byte*) p_zone->chunks[mid] <= (byte*) ptr) lo = mid;
+        else hi = mid;
+    }
+    E_Chunk* p_chunk = p_zone->chunks[lo];
+    if ((byte*) ptr >= (byte*) p_chunk->p_memory &&
+        (byte*) ptr < (byte*) p_chunk + p_chunk->size)
+        return p_chunk;
+    return NULL;
+}
+
+/* allocates a block whose address is a multiple of `alignment`, which is a
+ * power of 2–payloads are always aligned to 8 bytes anyway
+ */
+static void* E_Malloc_ (E_Zone* p_zone, size_t size, size_t alignment,
+                        int tag, void* requester)
 {
     // early return if the memory had not been initialized
-    if (!p_mainmemory)
+    if (!p_zone)
     {
         printf("E_Malloc: Uninitialized memory.\n");
         return NULL;
     }
-    // fix input size to a factor of 4
-    size = (size + 3) >> 2 << 2; // = (size + 3) & ~3 = 4 * ((size + 3) / 4)
-    // account for the header of the next block
-    int sizereq = size + SIZE_HEADER;
-    int lap = 0;
-    E_Memblock* p_start = p_rover, *p_current = p_rover;
-    /* try to find a big enough block to allocate for the requester */
-    while (!lap && (p_current->size < sizereq || p_current->owner != NULL))
-    {
-        p_current = p_current->p_next;
-        // wrap around and point back to the head of the main memory
-        if (p_current == NULL) p_current = p_mainmemory;
-        // if a full revolution is complete and an appropriate memory block
-        // had not been found, raise the `lap` flag
-        if (p_current == p_start) lap = 1;
-    }
-    if (lap)
-    {
-        printf("E_Malloc: Insufficient memory for %dBs.\n", size);
+    if (alignment & (alignment - 1))
+    {
+        printf("E_Malloc: Alignment of %zuBs is not a power of 2.\n",
+               alignment);
+        return NULL;
+    }
+    // fix input size to a factor of 8 to keep the block headers aligned
+    size = (size + 7) >> 3 << 3; // = (size + 7) & ~7 = 8 * ((size + 7) / 8)
+    /* leave room for a leading block to be split off, should the payload
+     * need to be pushed further to an aligned address
+     */
+    size_t sizesearch = size;
+    if (alignment > 8) sizesearch += alignment + SIZE_HEADER;
+    /* try to find a big enough block to allocate for the requester, and
+     * extend the zone if there's none
+     */
+    E_Memblock* p_current = E_BinFind(p_zone, sizesearch);
+    if (!p_current && (p_zone->flags & E_ZONE_GROWABLE) &&
+        E_Grow(p_zone, sizesearch))
+        p_current = E_BinFind(p_zone, sizesearch);
+    if (!p_current)
+    {
+        printf("E_Malloc: Insufficient memory for %zuBs.\n", size);
         return NULL;
     }
     /* found a block that is big enough for the requester */
-    int sizefound = p_current->size;
-    int nextsize = sizefound - sizereq;
+    E_BinRemove(p_zone, p_current);
+    /* split a free block off the beginning, so that the payload starts at an
+     * aligned address–the leading block needs room for a header of its own
+     */
+    if (alignment > 8)
+    {
+        size_t payload = (size_t) p_current + SIZE_HEADER;
+        size_t aligned = (payload + alignment - 1) & ~(alignment - 1);
+        while (aligned != payload && aligned - payload < SIZE_HEADER)
+            aligned += alignment;
+        size_t lead = aligned - payload;
+        if (lead)
+        {
+            E_Memblock* p_aligned = (E_Memblock*) ((byte*) p_current + lead);
+            E_Memblock* p_next = p_current->p_next;
+            E_InitBlock(p_aligned, p_current->size - lead, NULL, E_TAG_FREE,
+                        p_current, p_next);
+            if (p_next) p_next->p_prev = p_aligned;
+            p_current->size = lead - SIZE_HEADER;
+            p_current->p_next = p_aligned;
+            E_BinInsert(p_zone, p_current);
+            p_current = p_aligned;
+        }
+    }
     byte* p_freeroom = (byte*) p_current + SIZE_HEADER;
-    E_Memblock* p_newprev = p_current->p_prev;
-    E_Memblock* p_newnext = (E_Memblock*) (p_freeroom + size);
-    E_Memblock* p_newnextnext = p_current->p_next;
-    E_InitBlock(p_current, size, requester, E_TAG, p_newprev, p_newnext);
-    E_InitBlock(p_newnext, nextsize, NULL, E_TAG, p_current, p_newnextnext);
-    // fix the `prev` pointer of the next of the `newnext`
-    if (p_newnextnext) p_newnextnext->p_prev = p_newnext;
-    p_rover = p_newnext; // future searches for allocation will start here
+    /* split the remaining space off as a new free block, if there's room for
+     * a header–otherwise, hand the entire block over to the requester
+     */
+    if (p_current->size >= size + SIZE_HEADER)
+    {
+        size_t nextsize = p_current->size - size - SIZE_HEADER;
+        E_Memblock* p_newnext = (E_Memblock*) (p_freeroom + size);
+        E_Memblock* p_newnextnext = p_current->p_next;
+        E_InitBlock(p_current, size, requester, tag,
+                    p_current->p_prev, p_newnext);
+        E_InitBlock(p_newnext, nextsize, NULL, E_TAG_FREE,
+                    p_current, p_newnextnext);
+        // fix the `prev` pointer of the next of the `newnext`
+        if (p_newnextnext) p_newnextnext->p_prev = p_newnext;
+        E_BinInsert(p_zone, p_newnext);
+    }
+    else
+    {
+        p_current->owner = requester;
+        p_current->tag = tag;
+    }
+    p_current->p_handle = NULL; // not movable, unless asked for
+    p_current->stamp = 0; // not profiled, unless the profiler says otherwise
+    E_Touch(p_zone, p_current);
     // return the address for the newly allocated block
     return (void*) p_freeroom;
 }
 
-void* E_Free (void* ptr)
+static void* E_Free_ (E_Zone* p_zone, void* ptr)
 {
+    if (!p_zone)
+    {
+        printf("E_Free: Uninitialized memory.\n");
+        return NULL;
+    }
     E_Memblock* p_blockhead = (E_Memblock*) ((byte*) ptr - SIZE_HEADER);
     if (p_blockhead->owner == NULL)
     {
         printf("E_Free: The block does not have an owner.\n");
         return NULL;
     }
-    if (p_blockhead->tag != E_TAG)
+    if (p_blockhead->magic != E_MAGIC)
     {
         printf("E_Free: The block had not been initialized by E_Malloc.\n");
         return NULL;
     }
+    if (!E_FindChunk(p_zone, p_blockhead))
+    {
+        printf("E_Free: The block does not belong to the zone.\n");
+        return NULL;
+    }
     E_Memblock* p_prev = p_blockhead->p_prev;
     E_Memblock* p_next = p_blockhead->p_next;
-    int sizetotal = p_blockhead->size;
+    size_t sizetotal = p_blockhead->size;
     /* merge with next block if it is free */
     if (p_next != NULL && p_next->owner == NULL)
     {
+        E_BinRemove(p_zone, p_next);
+        E_Forget(p_zone, p_next, p_blockhead);
         sizetotal += p_next->size + SIZE_HEADER;
-        E_InitBlock(p_blockhead, sizetotal, NULL, E_TAG,
+        E_InitBlock(p_blockhead, sizetotal, NULL, E_TAG_FREE,
                     p_prev, p_next->p_next);
-        // back-up rover if it is pointing currently to `p_next`
-        if (p_rover == p_next) p_rover = p_blockhead;
         p_next = p_blockhead->p_next;
     }
     // if not, just free the block itself
-    else E_InitBlock(p_blockhead, sizetotal, NULL, E_TAG, p_prev, p_next);
+    else E_InitBlock(p_blockhead, sizetotal, NULL, E_TAG_FREE, p_prev, p_next);
     /* merge with previous block if it is free */
     if (p_prev != NULL && p_prev->owner == NULL)
     {
+        E_BinRemove(p_zone, p_prev);
+        E_Forget(p_zone, p_blockhead, p_prev);
         sizetotal += p_prev->size + SIZE_HEADER;
-        E_InitBlock(p_prev, sizetotal, NULL, E_TAG, p_prev->p_prev, p_next);
-        // back-up rover if it is pointing currently to `p_blockhead`
-        if (p_rover == p_blockhead) p_rover = p_prev;
+        E_InitBlock(p_prev, sizetotal, NULL, E_TAG_FREE, p_prev->p_prev,
+                    p_next);
         p_blockhead = p_prev;
     }
     // fix the `prev` pointer of the `next`
     if (p_next) p_next->p_prev = p_blockhead;
+    // file the merged block under its new size
+    E_BinInsert(p_zone, p_blockhead);
+    E_Touch(p_zone, p_blockhead);
     return p_blockhead;
 }
 
-void E_Memcpy (void* dest, void* src, int size)
+/* gives the tail of an allocated block back to the zone, if the tail is big
+ * enough to hold a header of its own
+ */
+static void E_Shrink (E_Zone* p_zone, E_Memblock* p_block, size_t size)
 {
-    byte *cpydest = (byte*) dest, *cpysrc = (byte*) src;
-    for (int i = 0; i < size; i += 1) *(cpydest + i) = *(cpysrc + i);
+    if (p_block->size < size + SIZE_HEADER) return;
+    size_t tailsize = p_block->size - size - SIZE_HEADER;
+    E_Memblock* p_tail = (E_Memblock*) ((byte*) p_block + SIZE_HEADER + size);
+    E_Memblock* p_next = p_block->p_next;
+    // initialize the tail as an allocated block, and let `E_Free` take care
+    // of merging it with its next and filing it under its bin
+    E_InitBlock(p_tail, tailsize, p_block->owner, p_block->tag, p_block,
+                p_next);
+    if (p_next) p_next->p_prev = p_tail;
+    p_block->size = size;
+    p_block->p_next = p_tail;
+    E_Free_(p_zone, (byte*) p_tail + SIZE_HEADER);
 }
 
-void* E_Realloc (void* ptr, int size)
+static void* E_Realloc_ (E_Zone* p_zone, void* ptr, size_t size,
+                         size_t alignment)
 {
+    if (!p_zone)
+    {
+        printf("E_Realloc: Uninitialized memory.\n");
+        return NULL;
+    }
     E_Memblock* p_blockhead = (E_Memblock*) ((byte*) ptr - SIZE_HEADER);
+    E_Memblock* p_next = p_blockhead->p_next;
+    size_t oldsize = p_blockhead->size;
+    ++p_zone->numreallocs;
+    size = (size + 7) >> 3 << 3; // same rounding as in `E_Malloc`
+    /* shrink in place by splitting off the tail */
+    if (size <= oldsize)
+    {
+        E_Shrink(p_zone, p_blockhead, size);
+        E_Touch(p_zone, p_blockhead);
+        ++p_zone->numinplace;
+        return ptr;
+    }
+    /* grow in place by absorbing the next block, if it is free and there's
+     * enough room in it
+     */
+    if (p_next != NULL && p_next->owner == NULL &&
+        oldsize + SIZE_HEADER + p_next->size >= size)
+    {
+        E_Memblock* p_nextnext = p_next->p_next;
+        E_BinRemove(p_zone, p_next);
+        E_Forget(p_zone, p_next, p_blockhead);
+        p_blockhead->size = oldsize + SIZE_HEADER + p_next->size;
+        p_blockhead->p_next = p_nextnext;
+        if (p_nextnext) p_nextnext->p_prev = p_blockhead;
+        E_Shrink(p_zone, p_blockhead, size); // give back what we don't need
+        E_Touch(p_zone, p_blockhead);
+        ++p_zone->numinplace;
+        return ptr;
+    }
     // try to allocate a new memory block with the requested size
-    byte* p_dest = (byte*) E_Malloc(size, p_blockhead->owner);
+    byte* p_dest = (byte*) E_Malloc_(p_zone, size, alignment,
+                                     p_blockhead->tag, p_blockhead->owner);
     // early return if a memory block with sufficient size could not be found
     if (p_dest == NULL)
     {
-        printf("E_Realloc: Insufficient memory for %dBs.\n", size);
+        printf("E_Realloc: Insufficient memory for %zuBs.\n", size);
         return NULL;
     }
     /* copy the old memory block to the newly malloced */
     byte* p_src = (byte*) p_blockhead + SIZE_HEADER;
-    E_Memcpy(p_dest, p_src, p_blockhead->size);
-    E_Free(p_src); // free the old block
+    E_Memcpy(p_dest, p_src, oldsize);
+    // a movable block takes its handle along
+    E_Handle* p_handle = p_blockhead->p_handle;
+    ((E_Memblock*) (p_dest - SIZE_HEADER))->p_handle = p_handle;
+    if (p_handle) p_handle->ptr = p_dest;
+    E_Free_(p_zone, p_src); // free the old block
     return (void*) p_dest;
 }
 
-void E_Dump (void)
+/* checks a single block against its neighbours, in O(1) */
+static int E_VerifyBlock (E_Zone* p_zone, E_Chunk* p_chunk,
+                          E_Memblock* p_current)
 {
-    if (!E_Verify())
+    int error = 0;
+    E_Memblock* p_prev = p_current->p_prev;
+    E_Memblock* p_next = p_current->p_next;
+
+    // add size of the block header to its allotted size and check if
+    // this address actually points to its `next`, or to the end of the
+    // chunk if the last block in the chunk
+    byte* p_end = (byte*) p_current + p_current->size + SIZE_HEADER;
+    if (p_next ? p_end != (byte*) p_next :
+                 p_end != (byte*) p_chunk + p_chunk->size)
+    {
+        printf("E_Verify: [%p] Block does not touch to its next.\n",
+               p_current);
+        error = 1;
+    }
+
+    if (p_prev ? p_prev->p_next != p_current : p_current != p_chunk->p_memory)
     {
-        printf("Heap dump @%p:\n\n", p_mainmemory);
-        for (E_Memblock* p_current = p_mainmemory; p_current;
+        printf("E_Verify: [%p] Block has an improper previous link.\n",
+               p_current);
+        error = 1;
+    }
+
+    if (p_next && p_next->p_prev != p_current)
+    {
+        printf("E_Verify: [%p] Block has an improper next link.\n",
+               p_current);
+        error = 1;
+    }
+
+    // bypass this test if the last block in the memory
+    if (p_next && !p_current->owner && !p_next->owner)
+    {
+        printf("E_Verify: [%p] Two consecutive vacant blocks in memory.\n",
+               p_current);
+        error = 1;
+    }
+
+    // memory block had not been initialized via `E_Malloc`
+    if (p_current->magic != E_MAGIC)
+    {
+        printf("E_Verify: [%p] The block had not been initialized by " \
+               "E_Malloc.\n", p_current);
+        error = 1;
+    }
+
+    // a free block should be linked into its bin
+    E_Memblock* p_prevfree = p_current->p_prevfree;
+    if (!p_current->owner && !error &&
+        (p_prevfree ? p_prevfree->p_nextfree != p_current :
+                      p_zone->p_bins[E_BinIndex(p_current->size)] !=
+                      p_current))
+    {
+        printf("E_Verify: [%p] Block has an improper previous link " \
+               "in its bin.\n", p_current);
+        error = 1;
+    }
+
+    return error;
+}
+
+static int E_VerifyChunk (E_Zone* p_zone, E_Chunk* p_chunk, int* p_numfree)
+{
+    int error = 0;
+    for (E_Memblock* p_current = p_chunk->p_memory; p_current && !error;
+         p_current = p_current->p_next)
+    {
+        error = E_VerifyBlock(p_zone, p_chunk, p_current);
+        if (!p_current->owner) ++*p_numfree;
+    }
+
+    return error;
+}
+
+static int E_Verify_ (E_Zone* p_zone)
+{
+    int error = 0, numfree = 0;
+    if (!p_zone)
+    {
+        printf("E_Verify: Uninitialized memory.\n");
+        error = 1;
+    }
+    for (E_Chunk* p_chunk = p_zone ? p_zone->p_chunks : NULL;
+         p_chunk && !error; p_chunk = p_chunk->p_next)
+        error = E_VerifyChunk(p_zone, p_chunk, &numfree);
+
+    /* every free block in the zone should be filed under its own bin, and
+     * nothing else
+     */
+    for (int bin = 0; bin < E_NUMBINS && !error; ++bin)
+    {
+        if (!p_zone->p_bins[bin] != !E_BinMapped(p_zone, bin) ||
+            !p_zone->binmap[bin >> 6] !=
+            !((p_zone->binsummary >> (bin >> 6)) & 1))
+        {
+            printf("E_Verify: [%d] Bin is out of sync with the bin map.\n",
+                   bin);
+            error = 1;
+        }
+        E_Memblock* p_prevfree = NULL;
+        for (E_Memblock* p_free = p_zone->p_bins[bin]; p_free && !error;
+             p_free = p_free->p_nextfree)
+        {
+            if (p_free->owner || E_BinIndex(p_free->size) != bin)
+            {
+                printf("E_Verify: [%p] Block does not belong in bin %d.\n",
+                       p_free, bin);
+                error = 1;
+            }
+            if (p_free->p_prevfree != p_prevfree)
+            {
+                printf("E_Verify: [%p] Block has an improper previous link " \
+                       "in its bin.\n", p_free);
+                error = 1;
+            }
+            p_prevfree = p_free;
+            --numfree;
+        }
+    }
+
+    if (!error && numfree)
+    {
+        printf("E_Verify: %d free block(s) missing from the bins.\n",
+               numfree);
+        error = 1;
+    }
+
+    return error;
+}
+
+/* verifies the blocks touched lately, along with their neighbours */
+static int E_VerifyRecent_ (E_Zone* p_zone)
+{
+    if (!p_zone)
+    {
+        printf("E_Verify: Uninitialized memory.\n");
+        return 1;
+    }
+    int error = 0;
+    for (int i = 0; i < E_NUMRECENT && !error; ++i)
+    {
+        E_Memblock* p_block = p_zone->p_recent[i];
+        if (!p_block) continue;
+        E_Chunk* p_chunk = E_FindChunk(p_zone, p_block);
+        if (!p_chunk)
+        {
+            printf("E_Verify: [%p] Block does not belong to the zone.\n",
+                   p_block);
+            return 1;
+        }
+        error = E_VerifyBlock(p_zone, p_chunk, p_block);
+        if (!error && p_block->p_prev)
+            error = E_VerifyBlock(p_zone, p_chunk, p_block->p_prev);
+        if (!error && p_block->p_next)
+            error = E_VerifyBlock(p_zone, p_chunk, p_block->p_next);
+    }
+    return error;
+}
+
+/* verifies the next `budget` blocks from where the last call left off,
+ * wrapping around at the end of the zone
+ */
+static int E_VerifyStep_ (E_Zone* p_zone, size_t budget)
+{
+    if (!p_zone)
+    {
+        printf("E_Verify: Uninitialized memory.\n");
+        return 1;
+    }
+    int error = 0;
+    for (size_t i = 0; i < budget && !error; ++i)
+    {
+        error = E_VerifyBlock(p_zone, p_zone->p_cursorchunk, p_zone->p_cursor);
+        /* move on to the next block, or the next chunk, or back to the start
+         * of the zone
+         */
+        p_zone->p_cursor = p_zone->p_cursor->p_next;
+        if (p_zone->p_cursor) continue;
+        p_zone->p_cursorchunk = p_zone->p_cursorchunk->p_next;
+        if (!p_zone->p_cursorchunk) p_zone->p_cursorchunk = p_zone->p_chunks;
+        p_zone->p_cursor = p_zone->p_cursorchunk->p_memory;
+    }
+    return error;
+}
+
+static void E_ZoneDump_ (E_Zone* p_zone)
+{
+    if (E_Verify_(p_zone)) return;
+    for (E_Chunk* p_chunk = p_zone->p_chunks; p_chunk;
+         p_chunk = p_chunk->p_next)
+    {
+        if (p_chunk == p_zone->p_chunks)
+            printf("Heap dump @%p:\n\n", p_chunk->p_memory);
+        else printf("\nChunk @%p:\n\n", p_chunk->p_memory);
+        for (E_Memblock* p_current = p_chunk->p_memory; p_current;
              p_current = p_current->p_next)
         {
             byte* ptr = (byte*) p_current;
             if (p_current->owner) ptr += SIZE_HEADER;
 
-            printf("loc: %p\tsize: %d", ptr, p_current->size);
+            printf("loc: %p\tsize: %zu", ptr, p_current->size);
 
-            if (p_current->owner) printf("\towner: %p", p_current->owner);
+            if (p_current->owner)
+                printf("\towner: %p\ttag: %d", p_current->owner,
+                       p_current->tag);
             else printf("\towner: NULL");
 
-            if (p_current == p_rover) printf("\t(*)");
-
             printf("\n");
         }
     }
+    if (p_zone->numreallocs)
+        printf("\nReallocs: %d (%d in place)\n",
+               p_zone->numreallocs, p_zone->numinplace);
 }
 
-int E_Verify (void)
+/* the blocks freed from a thread are first cached locally so that they can
+ * quickly be handed back to the same thread without locking the zone–as long
+ * as they are small, and they belong to the default zone
+ */
+#define E_CACHEDEPTH 32
+
+typedef struct {
+    E_Memblock* p_bins[E_NUMSMALLBINS];
+    int counts[E_NUMSMALLBINS];
+    int generation; // the generation of the zone the cached blocks belong to
+} E_Cache;
+
+static int concurrent = 0;
+// incremented every time the default zone is (re-)initialized or destroyed,
+// so that the caches left over from an older zone can be told apart
+static int generation = 0;
+static pthread_key_t cachekey;
+static pthread_once_t cachekeyonce = PTHREAD_ONCE_INIT;
+static __thread E_Cache cache;
+
+/* returns the cached blocks back to the zone when a thread exits */
+static void E_CacheFlush (void* p_cache_)
 {
-    E_Memblock* p_current = p_mainmemory;
-    int lap = 0, error = 0;
-    if (!p_current)
+    E_Cache* p_cache = (E_Cache*) p_cache_;
+    E_Zone* p_zone = p_defaultzone;
+    if (p_cache->generation == generation && p_zone)
     {
-        printf("E_Verify: Uninitialized memory.\n");
-        error = 1;
+        pthread_mutex_lock(&p_zone->lock);
+        for (int bin = 0; bin < E_NUMSMALLBINS; ++bin)
+        {
+            E_Memblock* p_block = p_cache->p_bins[bin];
+            while (p_block)
+            {
+                E_Memblock* p_nextfree = p_block->p_nextfree;
+                E_Free_(p_zone, (byte*) p_block + SIZE_HEADER);
+                p_block = p_nextfree;
+            }
+        }
+        pthread_mutex_unlock(&p_zone->lock);
     }
-    while (!lap && !error)
+    for (int bin = 0; bin < E_NUMSMALLBINS; ++bin)
     {
-        E_Memblock* p_next = p_current->p_next;
-        if (p_next == NULL) p_next = p_mainmemory;
+        p_cache->p_bins[bin] = NULL;
+        p_cache->counts[bin] = 0;
+    }
+}
 
-        E_Memblock* p_selftestprev = NULL;
-        if (p_current == p_mainmemory) p_selftestprev = p_current;
-        else p_selftestprev = p_current->p_prev->p_next;
+// the owner of the blocks sitting in a cache
+#define E_CACHED ((void*) E_CacheFlush)
 
-        E_Memblock* p_selftestnext = NULL;
-        if (p_next == p_mainmemory) p_selftestnext = p_current;
-        else p_selftestnext = p_current->p_next->p_prev;
+static void E_CacheInitKey (void)
+{
+    pthread_key_create(&cachekey, E_CacheFlush);
+}
 
-        if (
-            // bypass this test if the last block in the memory
-            p_next != p_mainmemory &&
-            // add size of the block header to its allotted size and check if
-            // this address actually points to its `next`
-            (byte*) p_current + p_current->size + SIZE_HEADER != (byte*) p_next)
+static E_Cache* E_GetCache (void)
+{
+    /* drop whatever is left from an older zone–those blocks are long gone */
+    if (cache.generation != generation)
+    {
+        for (int bin = 0; bin < E_NUMSMALLBINS; ++bin)
         {
-            printf("E_Verify: [%p] Block does not touch to its next.\n",
-                   p_current);
-            error = 1;
+            cache.p_bins[bin] = NULL;
+            cache.counts[bin] = 0;
         }
+        cache.generation = generation;
+        // register the cache to be flushed once the thread exits
+        pthread_once(&cachekeyonce, E_CacheInitKey);
+        pthread_setspecific(cachekey, &cache);
+    }
+    return &cache;
+}
+
+/* the profile of each owner is kept in an open-addressing hash table, keyed
+ * by the owner–the ones that don't fit are lumped together under NULL
+ */
+#define E_PROFILESLOTS 256
+
+typedef struct {
+    void* owner;
+    size_t livebytes, peakbytes;
+    size_t numallocs, numfrees;
+    double lifetime; // the total lifetime of the freed blocks, in seconds
+} E_OwnerProfile;
+
+static int profiling = 0;
+// when profiling last started–blocks stamped before it belong to an earlier
+// session, whose numbers are gone
+static unsigned long profilestart = 0;
+static E_OwnerProfile profiles[E_PROFILESLOTS];
+static E_OwnerProfile profileoverflow;
+static pthread_mutex_t profilelock = PTHREAD_MUTEX_INITIALIZER;
 
-        if (p_current != p_selftestprev)
+static unsigned long E_ProfileNow (void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+
+static E_OwnerProfile* E_ProfileFind (void* owner)
+{
+    size_t slot = ((size_t) owner >> 3) * 0x9e3779b97f4a7c15UL >> 56;
+    for (int i = 0; i < E_PROFILESLOTS; ++i)
+    {
+        E_OwnerProfile* p_profile = profiles + slot;
+        if (p_profile->owner == owner) return p_profile;
+        if (!p_profile->owner)
         {
-            printf("E_Verify: [%p] Block has an improper previous link.\n",
-                   p_current);
-            error = 1;
+            p_profile->owner = owner;
+            return p_profile;
         }
+        slot = (slot + 1) % E_PROFILESLOTS;
+    }
+    return &profileoverflow;
+}
+
+/* stamps a block that has just been handed out, and accounts for it */
+static void E_ProfileAlloc (E_Memblock* p_block)
+{
+    if (!profiling) return;
+    p_block->stamp = E_ProfileNow();
+    if (concurrent) pthread_mutex_lock(&profilelock);
+    E_OwnerProfile* p_profile = E_ProfileFind(p_block->owner);
+    p_profile->livebytes += p_block->size;
+    if (p_profile->livebytes > p_profile->peakbytes)
+        p_profile->peakbytes = p_profile->livebytes;
+    ++p_profile->numallocs;
+    if (concurrent) pthread_mutex_unlock(&profilelock);
+}
 
-        if (p_current != p_selftestnext)
+/* accounts for a block of `size` bytes, stamped with `stamp`, that has just
+ * been freed–or resized to `newsize` bytes, if it is not 0
+ */
+static void E_ProfileFree (void* owner, size_t size, unsigned long stamp,
+                           size_t newsize)
+{
+    // blocks handed out while not profiling, or in an earlier session, are of
+    // no interest
+    if (!profiling || !stamp || stamp < profilestart) return;
+    if (concurrent) pthread_mutex_lock(&profilelock);
+    E_OwnerProfile* p_profile = E_ProfileFind(owner);
+    p_profile->livebytes -= size;
+    if (newsize)
+    {
+        p_profile->livebytes += newsize;
+        if (p_profile->livebytes > p_profile->peakbytes)
+            p_profile->peakbytes = p_profile->livebytes;
+    }
+    else
+    {
+        ++p_profile->numfrees;
+        p_profile->lifetime += (E_ProfileNow() - stamp) * 1e-9;
+    }
+    if (concurrent) pthread_mutex_unlock(&profilelock);
+}
+
+/* the trace, if recording, is written to `p_tracefile` one record at a time,
+ * buffered by the standard library
+ */
+static FILE* p_tracefile = NULL;
+static unsigned long tracestart;
+static pthread_mutex_t tracelock = PTHREAD_MUTEX_INITIALIZER;
+
+static void E_Trace (int op, void* owner, void* ptr, void* result, size_t size,
+                     size_t alignment, int tag)
+{
+    if (!p_tracefile) return;
+    E_TraceRecord record;
+    record.time = E_ProfileNow() - tracestart;
+    record.owner = (unsigned long long) (size_t) owner;
+    record.ptr = (unsigned long long) (size_t) ptr;
+    record.result = (unsigned long long) (size_t) result;
+    record.size = size;
+    record.op = op;
+    record.alignment = alignment > 8 ? __builtin_ctzl(alignment) : 3;
+    record.tag = tag;
+    if (concurrent) pthread_mutex_lock(&tracelock);
+    if (p_tracefile) fwrite(&record, sizeof(E_TraceRecord), 1, p_tracefile);
+    if (concurrent) pthread_mutex_unlock(&tracelock);
+}
+
+/* hands out a handle from the free list of the zone, mapping a new page of
+ * them if it has run dry
+ */
+static E_Handle* E_NewHandle (E_Zone* p_zone)
+{
+    if (!p_zone->p_freehandles)
+    {
+        size_t size = E_HANDLEPAGE;
+        E_HandlePage* p_page = (E_HandlePage*) E_Map(&size, 0);
+        if (!p_page) return NULL;
+        p_page->size = size;
+        p_page->p_next = p_zone->p_handlepages;
+        p_zone->p_handlepages = p_page;
+        E_Handle* handles = (E_Handle*) ((byte*) p_page + SIZE_HANDLEPAGE);
+        size_t numhandles = (size - SIZE_HANDLEPAGE) / sizeof(E_Handle);
+        for (size_t i = 0; i < numhandles; ++i)
         {
-            printf("E_Verify: [%p] Block has an improper next link.\n",
-                   p_current);
-            error = 1;
+            handles[i].ptr = NULL;
+            handles[i].p_nextfree = p_zone->p_freehandles;
+            p_zone->p_freehandles = handles + i;
+        }
+    }
+    E_Handle* p_handle = p_zone->p_freehandles;
+    p_zone->p_freehandles = p_handle->p_nextfree;
+    p_handle->p_zone = p_zone;
+    p_handle->locks = 0;
+    return p_handle;
+}
+
+static void E_DropHandle (E_Zone* p_zone, E_Handle* p_handle)
+{
+    p_handle->ptr = NULL;
+    p_handle->p_nextfree = p_zone->p_freehandles;
+    p_zone->p_freehandles = p_handle;
+}
+
+static int E_Movable (E_Memblock* p_block)
+{
+    return p_block && p_block->owner && p_block->owner != E_CACHED &&
+           p_block->p_handle && !p_block->p_handle->locks;
+}
+
+/* slides the movable block right after the free block `p_free` down to the
+ * beginning of it, so that the free space ends up after the block instead,
+ * merged with whatever free block comes next–returns the moved block
+ */
+static E_Memblock* E_Slide (E_Zone* p_zone, E_Memblock* p_free)
+{
+    E_Memblock* p_block = p_free->p_next;
+    E_Memblock* p_next = p_block->p_next;
+    E_Memblock* p_prev = p_free->p_prev;
+    size_t freesize = p_free->size, blocksize = p_block->size;
+    void* ptr = (byte*) p_block + SIZE_HEADER;
+    E_BinRemove(p_zone, p_free);
+    E_Forget(p_zone, p_block, p_free);
+    // the regions may overlap, the header along with the payload
+    E_Memmove(p_free, p_block, SIZE_HEADER + blocksize);
+    p_block = p_free;
+    p_block->p_prev = p_prev;
+    p_block->p_handle->ptr = (byte*) p_block + SIZE_HEADER;
+    /* lay the free space out after the block, absorbing the next block if
+     * it is free as well
+     */
+    E_Memblock* p_newfree = (E_Memblock*) ((byte*) p_block + SIZE_HEADER +
+                                           blocksize);
+    if (p_next && !p_next->owner)
+    {
+        E_BinRemove(p_zone, p_next);
+        E_Forget(p_zone, p_next, p_newfree);
+        freesize += SIZE_HEADER + p_next->size;
+        p_next = p_next->p_next;
+    }
+    E_InitBlock(p_newfree, freesize, NULL, E_TAG_FREE, p_block, p_next);
+    if (p_next) p_next->p_prev = p_newfree;
+    p_block->p_next = p_newfree;
+    E_BinInsert(p_zone, p_newfree);
+    E_Touch(p_zone, p_block);
+    E_Trace(E_TRACE_MOVE, p_block->owner, ptr, (byte*) p_block + SIZE_HEADER,
+            blocksize, 0, p_block->tag);
+    return p_block;
+}
+
+/* slides every unlocked movable block down over the free space before it, so
+ * that the free space of each chunk gathers in as few blocks as possible
+ */
+static void E_Compact_ (E_Zone* p_zone)
+{
+    for (E_Chunk* p_chunk = p_zone->p_chunks; p_chunk;
+         p_chunk = p_chunk->p_next)
+    {
+        for (E_Memblock* p_current = p_chunk->p_memory; p_current;
+             p_current = p_current->p_next)
+            if (!p_current->owner && E_Movable(p_current->p_next))
+                p_current = E_Slide(p_zone, p_current);
+    }
+}
+
+E_Zone* E_ZoneCreate (size_t sizemib, int flags)
+{
+    size_t size = SIZE_CHUNK + SIZE_ZONE + SIZE_HEADER + (sizemib << 20);
+    // map an entire contiguous chunk of memory for the zone to manage, and
+    // keep the zone itself right at the beginning of it
+    void* ptr = E_Map(&size, flags);
+    if (!ptr)
+    {
+        printf("E_ZoneCreate: Could not allocate %zuMiBs.\n", sizemib);
+        return NULL;
+    }
+    E_Chunk* p_chunk = E_InitChunk(ptr, size, SIZE_CHUNK + SIZE_ZONE);
+    E_Zone* p_zone = (E_Zone*) ((byte*) ptr + SIZE_CHUNK);
+    p_zone->p_chunks = p_chunk;
+    p_zone->chunks[0] = p_chunk;
+    p_zone->numchunks = 1;
+    p_zone->chunksize = size;
+    p_zone->flags = flags;
+    // initialize the bins with the one and only free block
+    for (int i = 0; i < E_NUMBINS; ++i) p_zone->p_bins[i] = NULL;
+    for (int i = 0; i < E_NUMBINWORDS; ++i) p_zone->binmap[i] = 0;
+    p_zone->binsummary = 0;
+    E_BinInsert(p_zone, p_chunk->p_memory);
+    p_zone->numreallocs = 0; p_zone->numinplace = 0;
+    for (int i = 0; i < E_NUMRECENT; ++i) p_zone->p_recent[i] = NULL;
+    p_zone->nextrecent = 0; p_zone->tracking = 0;
+    p_zone->p_cursorchunk = p_chunk; p_zone->p_cursor = p_chunk->p_memory;
+    p_zone->p_handlepages = NULL; p_zone->p_freehandles = NULL;
+    pthread_mutex_init(&p_zone->lock, NULL);
+    return p_zone;
+}
+
+/* throws away the entire zone at once, along with every block in it */
+void E_ZoneDestroy (E_Zone* p_zone)
+{
+    if (!p_zone) return;
+    pthread_mutex_destroy(&p_zone->lock);
+    while (p_zone->p_handlepages)
+    {
+        E_HandlePage* p_page = p_zone->p_handlepages;
+        p_zone->p_handlepages = p_page->p_next;
+        munmap(p_page, p_page->size);
+    }
+    /* the first chunk hosts the zone itself, so unmap it last */
+    E_Chunk* p_first = p_zone->p_chunks;
+    E_Chunk* p_chunk = p_first->p_next;
+    while (p_chunk)
+    {
+        E_Chunk* p_next = p_chunk->p_next;
+        munmap(p_chunk, p_chunk->size);
+        p_chunk = p_next;
+    }
+    munmap(p_first, p_first->size);
+}
+
+/* stamps the block at `ptr` for the profiler and the trace, if it is not
+ * NULL
+ */
+static void* E_Stamp (void* ptr, size_t size, size_t alignment)
+{
+    if (!ptr) return NULL;
+    E_Memblock* p_block = (E_Memblock*) ((byte*) ptr - SIZE_HEADER);
+    E_ProfileAlloc(p_block);
+    E_Trace(E_TRACE_MALLOC, p_block->owner, NULL, ptr, size, alignment,
+            p_block->tag);
+    return ptr;
+}
+
+/* accounts for the block at `ptr` that has just been freed */
+static void E_Unstamp (void* ptr, void* owner, size_t size,
+                       unsigned long stamp)
+{
+    E_ProfileFree(owner, size, stamp, 0);
+    E_Trace(E_TRACE_FREE, owner, ptr, NULL, 0, 0, 0);
+}
+
+void* E_ZoneMalloc (E_Zone* p_zone, size_t size, void* requester)
+{
+    return E_ZoneMallocTag(p_zone, size, E_TAG_STATIC, requester);
+}
+
+void* E_ZoneMallocTag (E_Zone* p_zone, size_t size, int tag, void* requester)
+{
+    if (tag <= E_TAG_FREE)
+    {
+        printf("E_Malloc: Tag %d is reserved for free blocks.\n", tag);
+        return NULL;
+    }
+    if (!concurrent || !p_zone)
+        return E_Stamp(E_Malloc_(p_zone, size, 0, tag, requester), size, 0);
+    /* try the cache of the calling thread first */
+    size_t sizecached = (size + 7) >> 3 << 3;
+    if (p_zone == p_defaultzone && sizecached < E_SMALLMAX)
+    {
+        E_Cache* p_cache = E_GetCache();
+        int bin = sizecached >> 3;
+        E_Memblock* p_block = p_cache->p_bins[bin];
+        if (p_block)
+        {
+            p_cache->p_bins[bin] = p_block->p_nextfree;
+            --p_cache->counts[bin];
+            p_block->owner = requester;
+            p_block->tag = tag;
+            p_block->p_handle = NULL;
+            p_block->stamp = 0;
+            return E_Stamp((byte*) p_block + SIZE_HEADER, size, 0);
         }
+    }
+    pthread_mutex_lock(&p_zone->lock);
+    void* ptr = E_Malloc_(p_zone, size, 0, tag, requester);
+    pthread_mutex_unlock(&p_zone->lock);
+    return E_Stamp(ptr, size, 0);
+}
+
+void* E_ZoneMallocAligned (E_Zone* p_zone, size_t size, size_t alignment,
+                           void* requester)
+{
+    if (!concurrent || !p_zone)
+        return E_Stamp(E_Malloc_(p_zone, size, alignment, E_TAG_STATIC,
+                                 requester), size, alignment);
+    pthread_mutex_lock(&p_zone->lock);
+    void* ptr = E_Malloc_(p_zone, size, alignment, E_TAG_STATIC, requester);
+    pthread_mutex_unlock(&p_zone->lock);
+    return E_Stamp(ptr, size, alignment);
+}
 
-        // bypass this test if the last block in the memory
-        if (p_next != p_mainmemory && !p_current->owner && !p_next->owner)
+void* E_ZoneFree (E_Zone* p_zone, void* ptr)
+{
+    if (!p_zone) return E_Free_(p_zone, ptr);
+    E_Memblock* p_blockhead = (E_Memblock*) ((byte*) ptr - SIZE_HEADER);
+    // what the profiler needs to know, before the header is gone
+    void* owner = p_blockhead->owner;
+    size_t size = p_blockhead->size;
+    unsigned long stamp = p_blockhead->stamp;
+    if (!concurrent)
+    {
+        void* p_freed = E_Free_(p_zone, ptr);
+        if (p_freed) E_Unstamp(ptr, owner, size, stamp);
+        return p_freed;
+    }
+    if (p_blockhead->owner == E_CACHED)
+    {
+        printf("E_Free: The block had already been freed.\n");
+        return NULL;
+    }
+    /* keep the block in the cache of the calling thread if it is small, and
+     * the cache is not full yet
+     */
+    if (p_zone == p_defaultzone && p_blockhead->owner &&
+        p_blockhead->magic == E_MAGIC && p_blockhead->size < E_SMALLMAX)
+    {
+        E_Cache* p_cache = E_GetCache();
+        int bin = p_blockhead->size >> 3;
+        if (p_cache->counts[bin] < E_CACHEDEPTH)
         {
-            printf("E_Verify: [%p] Two consecutive vacant blocks in memory.\n",
-                   p_current);
-            error = 1;
+            p_blockhead->owner = E_CACHED;
+            p_blockhead->p_nextfree = p_cache->p_bins[bin];
+            p_cache->p_bins[bin] = p_blockhead;
+            ++p_cache->counts[bin];
+            E_Unstamp(ptr, owner, size, stamp);
+            return p_blockhead;
         }
+    }
+    pthread_mutex_lock(&p_zone->lock);
+    void* p_freed = E_Free_(p_zone, ptr);
+    pthread_mutex_unlock(&p_zone->lock);
+    if (p_freed) E_Unstamp(ptr, owner, size, stamp);
+    return p_freed;
+}
 
-        // memory block had not been initialized via `E_Malloc`
-        if (p_current->tag != E_TAG)
+/* frees every block tagged with a purge level in `[lo, hi]` in a single pass
+ * over the zone, returning the number of blocks freed–the blocks sitting in
+ * the caches of the threads are left alone
+ */
+size_t E_ZoneFreeTags (E_Zone* p_zone, int lo, int hi)
+{
+    if (!p_zone)
+    {
+        printf("E_FreeTags: Uninitialized memory.\n");
+        return 0;
+    }
+    if (lo <= E_TAG_FREE) lo = E_TAG_FREE + 1;
+    size_t numfreed = 0;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    for (E_Chunk* p_chunk = p_zone->p_chunks; p_chunk;
+         p_chunk = p_chunk->p_next)
+    {
+        E_Memblock* p_current = p_chunk->p_memory;
+        while (p_current)
         {
-            printf("E_Verify: [%p] The block had not been initialized by " \
-                   "E_Malloc.\n", p_current);
-            error = 1;
+            if (!p_current->owner || p_current->owner == E_CACHED ||
+                p_current->tag < lo || p_current->tag > hi)
+            {
+                p_current = p_current->p_next;
+                continue;
+            }
+            void* owner = p_current->owner;
+            size_t size = p_current->size;
+            unsigned long stamp = p_current->stamp;
+            // the freed block may have been merged with its neighbours, so
+            // carry on from whatever comes after the merged block
+            void* ptr = (byte*) p_current + SIZE_HEADER;
+            if (p_current->p_handle) E_DropHandle(p_zone, p_current->p_handle);
+            p_current = E_Free_(p_zone, ptr);
+            E_Unstamp(ptr, owner, size, stamp);
+            p_current = p_current->p_next;
+            ++numfreed;
         }
+    }
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    return numfreed;
+}
+
+void* E_ZoneRealloc (E_Zone* p_zone, void* ptr, size_t size)
+{
+    return E_ZoneReallocAligned(p_zone, ptr, size, 0);
+}
+
+/* the block keeps its address if it can be resized in place, and is moved
+ * to another block aligned to `alignment` otherwise
+ */
+void* E_ZoneReallocAligned (E_Zone* p_zone, void* ptr, size_t size,
+                            size_t alignment)
+{
+    if (!p_zone) return E_Realloc_(p_zone, ptr, size, alignment);
+    E_Memblock* p_blockhead = (E_Memblock*) ((byte*) ptr - SIZE_HEADER);
+    void* owner = p_blockhead->owner;
+    size_t oldsize = p_blockhead->size;
+    unsigned long stamp = p_blockhead->stamp;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    void* p_dest = E_Realloc_(p_zone, ptr, size, alignment);
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    if (!p_dest) return NULL;
+    /* the block keeps its age, even if it had to move, as long as it is
+     * accounted for in this session
+     */
+    E_Memblock* p_desthead = (E_Memblock*) ((byte*) p_dest - SIZE_HEADER);
+    if (!profiling || stamp < profilestart) stamp = 0;
+    p_desthead->stamp = stamp;
+    E_ProfileFree(owner, oldsize, stamp, p_desthead->size);
+    E_Trace(E_TRACE_REALLOC, owner, ptr, p_dest, size, alignment,
+            p_desthead->tag);
+    return p_dest;
+}
+
+/* allocates a block that may be moved around by `E_ZoneCompact` while it is
+ * not locked, returning a handle to it rather than its address
+ */
+E_Handle* E_ZoneHandleAlloc (E_Zone* p_zone, size_t size, void* requester)
+{
+    if (!p_zone)
+    {
+        printf("E_HandleAlloc: Uninitialized memory.\n");
+        return NULL;
+    }
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    E_Handle* p_handle = E_NewHandle(p_zone);
+    void* ptr = NULL;
+    if (!p_handle) printf("E_HandleAlloc: Could not allocate a handle.\n");
+    else ptr = E_Malloc_(p_zone, size, 0, E_TAG_STATIC, requester);
+    if (ptr)
+    {
+        ((E_Memblock*) ((byte*) ptr - SIZE_HEADER))->p_handle = p_handle;
+        p_handle->ptr = ptr;
+    }
+    else if (p_handle)
+    {
+        E_DropHandle(p_zone, p_handle);
+        p_handle = NULL;
+    }
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    E_Stamp(ptr, size, 0);
+    return p_handle;
+}
+
+/* pins the block down, and returns its address, which stays valid until the
+ * block is unlocked as many times as it has been locked
+ */
+void* E_HandleLock (E_Handle* p_handle)
+{
+    if (!p_handle || !p_handle->ptr)
+    {
+        printf("E_HandleLock: Invalid handle.\n");
+        return NULL;
+    }
+    E_Zone* p_zone = p_handle->p_zone;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    ++p_handle->locks;
+    void* ptr = p_handle->ptr;
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    return ptr;
+}
+
+void E_HandleUnlock (E_Handle* p_handle)
+{
+    if (!p_handle || !p_handle->ptr)
+    {
+        printf("E_HandleUnlock: Invalid handle.\n");
+        return;
+    }
+    E_Zone* p_zone = p_handle->p_zone;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    if (p_handle->locks) --p_handle->locks;
+    else printf("E_HandleUnlock: The handle is not locked.\n");
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+}
+
+/* frees the block of the handle, along with the handle itself, unless the
+ * handle is locked
+ */
+void E_HandleFree (E_Handle* p_handle)
+{
+    if (!p_handle || !p_handle->ptr)
+    {
+        printf("E_HandleFree: Invalid handle.\n");
+        return;
+    }
+    E_Zone* p_zone = p_handle->p_zone;
+    /* the block may be moved by a compaction until the lock is taken, so
+     * only look at it afterwards
+     */
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    void* ptr = p_handle->ptr;
+    int locks = p_handle->locks;
+    if (!ptr || locks)
+    {
+        if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+        if (!ptr) printf("E_HandleFree: Invalid handle.\n");
+        else printf("E_HandleFree: The handle is locked %d time(s).\n", locks);
+        return;
+    }
+    E_Memblock* p_blockhead = (E_Memblock*) ((byte*) ptr - SIZE_HEADER);
+    void* owner = p_blockhead->owner;
+    size_t size = p_blockhead->size;
+    unsigned long stamp = p_blockhead->stamp;
+    void* p_freed = E_Free_(p_zone, ptr);
+    if (p_freed) E_DropHandle(p_zone, p_handle);
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    if (p_freed) E_Unstamp(ptr, owner, size, stamp);
+}
 
-        p_current = p_next;
-        // reached to the end of the main memory
-        if (p_current == p_mainmemory) lap = 1;
+/* slides the unlocked movable blocks together, updating their handles, and
+ * returns the size of the biggest free block afterwards
+ */
+size_t E_ZoneCompact (E_Zone* p_zone)
+{
+    if (!p_zone)
+    {
+        printf("E_Compact: Uninitialized memory.\n");
+        return 0;
     }
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    E_Compact_(p_zone);
+    size_t largest = E_LargestFree_(p_zone);
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    return largest;
+}
 
+int E_ZoneVerify (E_Zone* p_zone)
+{
+    if (!concurrent || !p_zone) return E_Verify_(p_zone);
+    pthread_mutex_lock(&p_zone->lock);
+    int error = E_Verify_(p_zone);
+    pthread_mutex_unlock(&p_zone->lock);
     return error;
 }
+
+/* starts remembering the blocks touched from now on for `E_ZoneVerifyRecent`,
+ * or stops
+ */
+void E_ZoneTrackRecent (E_Zone* p_zone, int enabled)
+{
+    if (!p_zone) return;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    for (int i = 0; i < E_NUMRECENT; ++i) p_zone->p_recent[i] = NULL;
+    p_zone->tracking = enabled;
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+}
+
+int E_ZoneVerifyRecent (E_Zone* p_zone)
+{
+    if (!concurrent || !p_zone) return E_VerifyRecent_(p_zone);
+    pthread_mutex_lock(&p_zone->lock);
+    int error = E_VerifyRecent_(p_zone);
+    pthread_mutex_unlock(&p_zone->lock);
+    return error;
+}
+
+int E_ZoneVerifyStep (E_Zone* p_zone, size_t budget)
+{
+    if (!concurrent || !p_zone) return E_VerifyStep_(p_zone, budget);
+    pthread_mutex_lock(&p_zone->lock);
+    int error = E_VerifyStep_(p_zone, budget);
+    pthread_mutex_unlock(&p_zone->lock);
+    return error;
+}
+
+size_t E_ZoneLargestFree (E_Zone* p_zone)
+{
+    if (!p_zone) return 0;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    size_t largest = E_LargestFree_(p_zone);
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+    return largest;
+}
+
+/* fills `p_stats` in with how much of the zone is mapped, used and free, by
+ * walking every block in O(n)
+ */
+void E_ZoneGetStats (E_Zone* p_zone, E_Stats* p_stats)
+{
+    E_Memset(p_stats, 0, sizeof(E_Stats));
+    if (!p_zone) return;
+    if (concurrent) pthread_mutex_lock(&p_zone->lock);
+    for (E_Chunk* p_chunk = p_zone->p_chunks; p_chunk;
+         p_chunk = p_chunk->p_next)
+    {
+        p_stats->mapped += p_chunk->size;
+        for (E_Memblock* p_current = p_chunk->p_memory; p_current;
+             p_current = p_current->p_next)
+        {
+            if (p_current->owner)
+            {
+                p_stats->used += p_current->size;
+                ++p_stats->numused;
+            }
+            else
+            {
+                p_stats->free += p_current->size;
+                ++p_stats->numfree;
+            }
+        }
+    }
+    p_stats->largestfree = E_LargestFree_(p_zone);
+    if (concurrent) pthread_mutex_unlock(&p_zone->lock);
+}
+
+void E_ZoneDump (E_Zone* p_zone)
+{
+    if (!concurrent || !p_zone) { E_ZoneDump_(p_zone); return; }
+    pthread_mutex_lock(&p_zone->lock);
+    E_ZoneDump_(p_zone);
+    pthread_mutex_unlock(&p_zone->lock);
+}
+
+void E_Init (size_t sizemib)
+{
+    p_defaultzone = E_ZoneCreate(sizemib, E_ZONE_GROWABLE);
+    ++generation;
+}
+
+void E_Destroy (void)
+{
+    E_ZoneDestroy(p_defaultzone);
+    p_defaultzone = NULL;
+    ++generation;
+}
+
+/* changes every time the default zone is (re-)initialized or destroyed, so
+ * that whatever holds on to blocks across calls can tell if they are gone
+ */
+int E_Generation (void)
+{
+    return generation;
+}
+
+void E_Concurrent (int enabled)
+{
+    // hand the blocks cached by the calling thread back to the zone before
+    // going back to the single-threaded mode
+    if (concurrent && !enabled) E_CacheFlush(E_GetCache());
+    concurrent = enabled;
+}
+
+/* starts recording every allocation, free and realloc to the file at `path`
+ * as `E_TraceRecord`s, returning non-zero on failure
+ */
+int E_TraceStart (const char* path)
+{
+    E_TraceStop();
+    FILE* p_file = fopen(path, "wb");
+    if (!p_file)
+    {
+        printf("E_TraceStart: Could not open %s.\n", path);
+        return 1;
+    }
+    tracestart = E_ProfileNow();
+    p_tracefile = p_file;
+    return 0;
+}
+
+void E_TraceStop (void)
+{
+    if (!p_tracefile) return;
+    if (concurrent) pthread_mutex_lock(&tracelock);
+    fclose(p_tracefile);
+    p_tracefile = NULL;
+    if (concurrent) pthread_mutex_unlock(&tracelock);
+}
+
+/* starts profiling the blocks handed out from now on with a clean slate, or
+ * stops profiling, keeping what's been gathered so far
+ */
+void E_Profiling (int enabled)
+{
+    if (enabled && !profiling)
+    {
+        for (int i = 0; i < E_PROFILESLOTS; ++i)
+        {
+            E_OwnerProfile profile = { NULL, 0, 0, 0, 0, 0 };
+            profiles[i] = profile;
+        }
+        E_OwnerProfile overflow = { NULL, 0, 0, 0, 0, 0 };
+        profileoverflow = overflow;
+        profilestart = E_ProfileNow();
+    }
+    profiling = enabled;
+}
+
+static double E_AverageLifetime (E_OwnerProfile* p_profile)
+{
+    if (!p_profile->numfrees) return 0;
+    return p_profile->lifetime / p_profile->numfrees;
+}
+
+void E_Profile (void)
+{
+    if (concurrent) pthread_mutex_lock(&profilelock);
+    printf("Profile:\n\n");
+    printf("%-18s %12s %12s %10s %10s %14s\n", "owner", "live (B)",
+           "peak (B)", "allocs", "frees", "avg life (ms)");
+    for (int i = 0; i <= E_PROFILESLOTS; ++i)
+    {
+        E_OwnerProfile* p_profile =
+            i < E_PROFILESLOTS ? profiles + i : &profileoverflow;
+        if (!p_profile->numallocs) continue;
+        if (p_profile->owner) printf("%-18p", p_profile->owner);
+        else printf("%-18s", "(others)");
+        printf(" %12zu %12zu %10zu %10zu %14.3f\n", p_profile->livebytes,
+               p_profile->peakbytes, p_profile->numallocs,
+               p_profile->numfrees, E_AverageLifetime(p_profile) * 1e3);
+    }
+    if (concurrent) pthread_mutex_unlock(&profilelock);
+}
+
+/* writes the profile of each owner to the file at `path` (or to the standard
+ * output if NULL) as CSV, returning non-zero on failure
+ */
+int E_ProfileDump (const char* path)
+{
+    FILE* p_file = path ? fopen(path, "w") : stdout;
+    if (!p_file)
+    {
+        printf("E_ProfileDump: Could not open %s.\n", path);
+        return 1;
+    }
+    if (concurrent) pthread_mutex_lock(&profilelock);
+    fprintf(p_file, "owner,live_bytes,peak_bytes,allocs,frees,"
+            "avg_lifetime_s\n");
+    for (int i = 0; i <= E_PROFILESLOTS; ++i)
+    {
+        E_OwnerProfile* p_profile =
+            i < E_PROFILESLOTS ? profiles + i : &profileoverflow;
+        if (!p_profile->numallocs) continue;
+        if (p_profile->owner) fprintf(p_file, "%p", p_profile->owner);
+        else fprintf(p_file, "others");
+        fprintf(p_file, ",%zu,%zu,%zu,%zu,%.9f\n", p_profile->livebytes,
+                p_profile->peakbytes, p_profile->numallocs,
+                p_profile->numfrees, E_AverageLifetime(p_profile));
+    }
+    if (concurrent) pthread_mutex_unlock(&profilelock);
+    if (path) fclose(p_file);
+    return 0;
+}
+
+void* E_Malloc (size_t size, void* requester)
+{
+    return E_ZoneMalloc(p_defaultzone, size, requester);
+}
+
+void* E_MallocTag (size_t size, int tag, void* requester)
+{
+    return E_ZoneMallocTag(p_defaultzone, size, tag, requester);
+}
+
+void* E_MallocAligned (size_t size, size_t alignment, void* requester)
+{
+    return E_ZoneMallocAligned(p_defaultzone, size, alignment, requester);
+}
+
+void* E_Free (void* ptr)
+{
+    return E_ZoneFree(p_defaultzone, ptr);
+}
+
+size_t E_FreeTags (int lo, int hi)
+{
+    return E_ZoneFreeTags(p_defaultzone, lo, hi);
+}
+
+void* E_Realloc (void* ptr, size_t size)
+{
+    return E_ZoneRealloc(p_defaultzone, ptr, size);
+}
+
+void* E_ReallocAligned (void* ptr, size_t size, size_t alignment)
+{
+    return E_ZoneReallocAligned(p_defaultzone, ptr, size, alignment);
+}
+
+int E_Verify (void)
+{
+    return E_ZoneVerify(p_defaultzone);
+}
+
+void E_TrackRecent (int enabled)
+{
+    E_ZoneTrackRecent(p_defaultzone, enabled);
+}
+
+int E_VerifyRecent (void)
+{
+    return E_ZoneVerifyRecent(p_defaultzone);
+}
+
+int E_VerifyStep (size_t budget)
+{
+    return E_ZoneVerifyStep(p_defaultzone, budget);
+}
+
+size_t E_LargestFree (void)
+{
+    return E_ZoneLargestFree(p_defaultzone);
+}
+
+E_Handle* E_HandleAlloc (size_t size, void* requester)
+{
+    return E_ZoneHandleAlloc(p_defaultzone, size, requester);
+}
+
+size_t E_Compact (void)
+{
+    return E_ZoneCompact(p_defaultzone);
+}
+
+void E_GetStats (E_Stats* p_stats)
+{
+    E_ZoneGetStats(p_defaultzone, p_stats);
+}
+
+void E_Dump (void)
+{
+    E_ZoneDump(p_defaultzone);
+}
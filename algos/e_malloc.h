@@ -8,40 +8,233 @@
  *      My very own custom memory allocator. (The prefix 'E' stands for 'Emre'–
  *      I know, I know...)
  *
- *      Exposes a single memory zone available for allocation. There is never
+ *      Exposes a default memory zone available for allocation. There is never
  *      any space between memory blocks, and there will never be two contiguous
  *      free memory blocks.
+ *
+ *      Independent zones can be created with `E_ZoneCreate`, and used through
+ *      the `E_Zone` variants of the functions, e.g., so that each subsystem
+ *      can have an arena of its own. A zone is thrown away as a whole with
+ *      `E_ZoneDestroy`, along with every block in it, in O(1).
+ *
+ *      A growable zone extends itself by mapping extra chunks of memory from
+ *      the system once it is full, optionally backed by huge pages, each
+ *      twice as large as the one before. The blocks of each chunk form a list
+ *      of their own, and the blocks in different chunks are never merged. The
+ *      default zone is always growable.
+ *
+ *      Payloads are aligned to 8 bytes. Stricter alignments, e.g., for SIMD
+ *      loads or cache lines, can be asked for with `E_MallocAligned`. Such
+ *      blocks are freed as usual, but should be resized with
+ *      `E_ReallocAligned` to stay aligned if they have to move.
+ *
+ *      The routines to copy and fill memory live in "e_memcpy.h", which is
+ *      included here for convenience.
+ *
+ *      Each block is tagged with a purge level, `E_TAG_STATIC` unless asked
+ *      otherwise with `E_MallocTag`. `E_FreeTags` frees every block within a
+ *      range of tags at once, e.g., the scratch data of a frame.
+ *
+ *      Free blocks are additionally kept in segregated free lists (bins),
+ *      indexed by their size class, so that a fitting block can be found
+ *      without walking the entire zone. Big blocks are picked by best fit,
+ *      to keep the zone from fragmenting. `E_LargestFree` tells the biggest
+ *      block that can be allocated without growing the zone.
+ *
+ *      `E_Verify` checks the entire zone in O(n). For cheaper checks that can
+ *      be left on, `E_VerifyRecent` checks only the blocks touched by the
+ *      latest calls (once enabled with `E_TrackRecent`) and their neighbours,
+ *      and `E_VerifyStep` checks the next few blocks each call, sweeping the
+ *      zone over time.
+ *
+ *      Blocks allocated with `E_HandleAlloc` are movable: they are reached
+ *      through a handle, which is locked with `E_HandleLock` to get the
+ *      address of the block, and unlocked with `E_HandleUnlock` once done
+ *      with it. `E_Compact` slides the unlocked ones together to gather the
+ *      free space stranded between them, and updates their handles. Free
+ *      them with `E_HandleFree`, never with `E_Free`.
+ *
+ *      In concurrent mode, the zones are guarded by a lock, and each thread
+ *      keeps a small cache of the blocks it recently freed from the default
+ *      zone, which it can re-use without taking the lock. Switch modes only
+ *      while a single thread is running, and make sure the worker threads
+ *      have exited before calling `E_Destroy`.
+ *
+ *      In profiling mode, the live and peak bytes, the number of allocations
+ *      and frees, and the average lifetime of the blocks are kept for each
+ *      owner, i.e., the `requester` of the block. `E_Profile` prints them out,
+ *      and `E_ProfileDump` writes them as CSV.
+ *
+ *      `E_TraceStart` records every allocation, free and realloc from then on
+ *      to a file, as a stream of `E_TraceRecord`s, until `E_TraceStop`. The
+ *      trace can be replayed later with `algs replay`, to compare allocators
+ *      on a real workload. `E_GetStats` tells the footprint of a zone.
  */
 
 #ifndef e_malloc_h
 
 #include "t_typedef.h"
+#include "e_memcpy.h"
 
 #define e_malloc_h
 #define e_malloc_h_E_Memblock E_Memblock
+#define e_malloc_h_E_Zone E_Zone
+#define e_malloc_h_E_Handle E_Handle
 #define e_malloc_h_E_Init E_Init
 #define e_malloc_h_E_Destroy E_Destroy
+#define e_malloc_h_E_Generation E_Generation
+#define e_malloc_h_E_Concurrent E_Concurrent
 #define e_malloc_h_E_Malloc E_Malloc
+#define e_malloc_h_E_MallocTag E_MallocTag
+#define e_malloc_h_E_MallocAligned E_MallocAligned
 #define e_malloc_h_E_Free E_Free
-#define e_malloc_h_E_Memcpy E_Memcpy
+#define e_malloc_h_E_FreeTags E_FreeTags
 #define e_malloc_h_E_Relloc E_Realloc
+#define e_malloc_h_E_ReallocAligned E_ReallocAligned
 #define e_malloc_h_E_Verify E_Verify
+#define e_malloc_h_E_TrackRecent E_TrackRecent
+#define e_malloc_h_E_VerifyRecent E_VerifyRecent
+#define e_malloc_h_E_VerifyStep E_VerifyStep
+#define e_malloc_h_E_LargestFree E_LargestFree
+#define e_malloc_h_E_HandleAlloc E_HandleAlloc
+#define e_malloc_h_E_HandleLock E_HandleLock
+#define e_malloc_h_E_HandleUnlock E_HandleUnlock
+#define e_malloc_h_E_HandleFree E_HandleFree
+#define e_malloc_h_E_Compact E_Compact
 #define e_malloc_h_E_Dump E_Dump
+#define e_malloc_h_E_Profiling E_Profiling
+#define e_malloc_h_E_Profile E_Profile
+#define e_malloc_h_E_ProfileDump E_ProfileDump
+#define e_malloc_h_E_TraceRecord E_TraceRecord
+#define e_malloc_h_E_TraceStart E_TraceStart
+#define e_malloc_h_E_TraceStop E_TraceStop
+#define e_malloc_h_E_Stats E_Stats
+#define e_malloc_h_E_GetStats E_GetStats
+#define e_malloc_h_E_ZoneCreate E_ZoneCreate
+#define e_malloc_h_E_ZoneDestroy E_ZoneDestroy
+#define e_malloc_h_E_ZoneMalloc E_ZoneMalloc
+#define e_malloc_h_E_ZoneMallocTag E_ZoneMallocTag
+#define e_malloc_h_E_ZoneMallocAligned E_ZoneMallocAligned
+#define e_malloc_h_E_ZoneFree E_ZoneFree
+#define e_malloc_h_E_ZoneFreeTags E_ZoneFreeTags
+#define e_malloc_h_E_ZoneRealloc E_ZoneRealloc
+#define e_malloc_h_E_ZoneReallocAligned E_ZoneReallocAligned
+#define e_malloc_h_E_ZoneVerify E_ZoneVerify
+#define e_malloc_h_E_ZoneTrackRecent E_ZoneTrackRecent
+#define e_malloc_h_E_ZoneVerifyRecent E_ZoneVerifyRecent
+#define e_malloc_h_E_ZoneVerifyStep E_ZoneVerifyStep
+#define e_malloc_h_E_ZoneLargestFree E_ZoneLargestFree
+#define e_malloc_h_E_ZoneGetStats E_ZoneGetStats
+#define e_malloc_h_E_ZoneHandleAlloc E_ZoneHandleAlloc
+#define e_malloc_h_E_ZoneCompact E_ZoneCompact
+#define e_malloc_h_E_ZoneDump E_ZoneDump
 
 typedef struct memblock {
-    int size;
+    size_t size;
     void* owner;
-    int tag;
+    int tag; // the purge level, see `E_MallocTag`
+    unsigned int magic; // tells the headers initialized by `E_Malloc` apart
     struct memblock *p_prev, *p_next;
+    union {
+        // links to the neighbours in the bin, only meaningful for free blocks
+        struct memblock* p_nextfree;
+        // the handle of a movable block, NULL for the other allocated ones
+        struct handle* p_handle;
+    };
+    union {
+        struct memblock* p_prevfree;
+        // when an allocated block was handed out in profiling mode, in
+        // nanoseconds, or 0 if it wasn't
+        unsigned long stamp;
+    };
 } E_Memblock;
 
-void E_Init (int sizemib);
+typedef struct zone E_Zone;
+typedef struct handle E_Handle;
+
+/* purge levels for `E_MallocTag`, any other positive tag will also do */
+#define E_TAG_STATIC 1 // the default, freed only one by one
+#define E_TAG_SCRATCH 100 // e.g., temporaries to be dropped after a frame
+
+/* flags for `E_ZoneCreate` */
+#define E_ZONE_GROWABLE 1 // map more memory from the system once full
+#define E_ZONE_HUGEPAGES 2 // try to back the zone with huge pages
+
+/* operations in a trace */
+#define E_TRACE_MALLOC 0
+#define E_TRACE_FREE 1
+#define E_TRACE_REALLOC 2
+#define E_TRACE_MOVE 3 // a movable block slid by `E_Compact`
+
+/* a single operation in a trace, of a fixed size regardless of the platform
+ * so that traces can be moved around
+ */
+typedef struct {
+    unsigned long long time; // since `E_TraceStart`, in nanoseconds
+    unsigned long long owner;
+    unsigned long long ptr; // the block freed or resized, if any
+    unsigned long long result; // the block handed out, if any
+    unsigned long long size;
+    unsigned short op;
+    unsigned short alignment; // log2 of the alignment asked for
+    int tag;
+} E_TraceRecord;
+
+typedef struct {
+    size_t mapped; // bytes mapped from the system, headers included
+    size_t used, free; // bytes in the payloads of used and free blocks
+    size_t largestfree;
+    size_t numused, numfree;
+} E_Stats;
+
+void E_Init (size_t sizemib);
 void E_Destroy (void);
-void* E_Malloc (int size, void* requester);
+int E_Generation (void);
+void E_Concurrent (int enabled);
+void* E_Malloc (size_t size, void* requester);
+void* E_MallocTag (size_t size, int tag, void* requester);
+void* E_MallocAligned (size_t size, size_t alignment, void* requester);
 void* E_Free (void* ptr);
-void E_Memcpy (void* dest, void* src, int size);
-void* E_Realloc (void* ptr, int size);
+size_t E_FreeTags (int lo, int hi);
+void* E_Realloc (void* ptr, size_t size);
+void* E_ReallocAligned (void* ptr, size_t size, size_t alignment);
 int E_Verify (void);
+void E_TrackRecent (int enabled);
+int E_VerifyRecent (void);
+int E_VerifyStep (size_t budget);
+size_t E_LargestFree (void);
+E_Handle* E_HandleAlloc (size_t size, void* requester);
+void* E_HandleLock (E_Handle* p_handle);
+void E_HandleUnlock (E_Handle* p_handle);
+void E_HandleFree (E_Handle* p_handle);
+size_t E_Compact (void);
 void E_Dump (void);
+void E_Profiling (int enabled);
+void E_Profile (void);
+int E_ProfileDump (const char* path);
+int E_TraceStart (const char* path);
+void E_TraceStop (void);
+void E_GetStats (E_Stats* p_stats);
+E_Zone* E_ZoneCreate (size_t sizemib, int flags);
+void E_ZoneDestroy (E_Zone* p_zone);
+void* E_ZoneMalloc (E_Zone* p_zone, size_t size, void* requester);
+void* E_ZoneMallocTag (E_Zone* p_zone, size_t size, int tag,
+                       void* requester);
+void* E_ZoneMallocAligned (E_Zone* p_zone, size_t size, size_t alignment,
+                           void* requester);
+void* E_ZoneFree (E_Zone* p_zone, void* ptr);
+size_t E_ZoneFreeTags (E_Zone* p_zone, int lo, int hi);
+void* E_ZoneRealloc (E_Zone* p_zone, void* ptr, size_t size);
+void* E_ZoneReallocAligned (E_Zone* p_zone, void* ptr, size_t size,
+                            size_t alignment);
+int E_ZoneVerify (E_Zone* p_zone);
+void E_ZoneTrackRecent (E_Zone* p_zone, int enabled);
+int E_ZoneVerifyRecent (E_Zone* p_zone);
+int E_ZoneVerifyStep (E_Zone* p_zone, size_t budget);
+size_t E_ZoneLargestFree (E_Zone* p_zone);
+void E_ZoneGetStats (E_Zone* p_zone, E_Stats* p_stats);
+E_Handle* E_ZoneHandleAlloc (E_Zone* p_zone, size_t size, void* requester);
+size_t E_ZoneCompact (E_Zone* p_zone);
+void E_ZoneDump (E_Zone* p_zone);
 
 #endif
@@ -0,0 +1,404 @@
+/*
+ *  e_memcpy.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Routines to copy and fill memory, used by the custom memory allocator
+ *      and its clients.
+ *
+ *      Each routine comes in byte-wide, word-wide, SSE2 and AVX2 flavours.
+ *      The widest one the CPU supports is picked at runtime, unless told
+ *      otherwise via `E_MemSelect`.
+ */
+
+#include "e_memcpy.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define E_X86
+#include <immintrin.h>
+#endif
+
+/* GCC would otherwise happily turn the plain loops below into calls to the
+ * C standard library
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define E_NOLIBCALL \
+    __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define E_NOLIBCALL
+#endif
+
+// copies of this size or bigger bypass the caches with non-temporal stores
+#define E_STREAMMIN (4 * 1024 * 1024)
+
+typedef size_t __attribute__((may_alias, aligned(1))) E_Word;
+
+typedef void (*E_CopyFunc) (byte* dest, const byte* src, size_t size);
+typedef void (*E_SetFunc) (byte* dest, byte value, size_t size);
+
+static E_CopyFunc p_copy = NULL;
+static E_CopyFunc p_moveforward = NULL;
+static E_CopyFunc p_movebackward = NULL;
+static E_SetFunc p_set = NULL;
+
+/* byte-wide */
+
+static E_NOLIBCALL void E_CopyBytes (byte* dest, const byte* src, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) *(dest + i) = *(src + i);
+}
+
+static E_NOLIBCALL void E_CopyBytesBackward (byte* dest, const byte* src,
+                                             size_t size)
+{
+    while (size--) *(dest + size) = *(src + size);
+}
+
+static E_NOLIBCALL void E_SetBytes (byte* dest, byte value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) *(dest + i) = value;
+}
+
+/* word-wide: each word is read before it is written, so copying forwards is
+ * safe when `dest` is below `src`, and copying backwards is safe otherwise
+ */
+
+static E_NOLIBCALL void E_CopyWords (byte* dest, const byte* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + sizeof(E_Word) <= size; i += sizeof(E_Word))
+        *((E_Word*) (dest + i)) = *((const E_Word*) (src + i));
+    E_CopyBytes(dest + i, src + i, size - i);
+}
+
+static E_NOLIBCALL void E_CopyWordsBackward (byte* dest, const byte* src,
+                                             size_t size)
+{
+    for (; size >= sizeof(E_Word); size -= sizeof(E_Word))
+        *((E_Word*) (dest + size - sizeof(E_Word))) =
+            *((const E_Word*) (src + size - sizeof(E_Word)));
+    E_CopyBytesBackward(dest, src, size);
+}
+
+static E_NOLIBCALL void E_SetWords (byte* dest, byte value, size_t size)
+{
+    size_t word = (size_t) -1 / 0xff * value; // `value` in every byte
+    size_t i = 0;
+    for (; i + sizeof(E_Word) <= size; i += sizeof(E_Word))
+        *((E_Word*) (dest + i)) = word;
+    E_SetBytes(dest + i, value, size - i);
+}
+
+#ifdef E_X86
+
+/* SSE2: 16 bytes at a time
+ *
+ * non-overlapping copies first store an unaligned head, then carry on with
+ * aligned stores, and finish with an unaligned tail that may overlap what's
+ * already been copied
+ */
+
+__attribute__((target("sse2")))
+static void E_CopySSE2 (byte* dest, const byte* src, size_t size)
+{
+    if (size < 16) { E_CopyWords(dest, src, size); return; }
+    __m128i tail = _mm_loadu_si128((const __m128i*) (src + size - 16));
+    _mm_storeu_si128((__m128i*) dest, _mm_loadu_si128((const __m128i*) src));
+    size_t i = 16 - ((size_t) dest & 15);
+    if (size >= E_STREAMMIN)
+    {
+        for (; i + 64 <= size; i += 64)
+        {
+            const __m128i* p_src = (const __m128i*) (src + i);
+            __m128i a = _mm_loadu_si128(p_src);
+            __m128i b = _mm_loadu_si128(p_src + 1);
+            __m128i c = _mm_loadu_si128(p_src + 2);
+            __m128i d = _mm_loadu_si128(p_src + 3);
+            __m128i* p_dest = (__m128i*) (dest + i);
+            _mm_stream_si128(p_dest, a);
+            _mm_stream_si128(p_dest + 1, b);
+            _mm_stream_si128(p_dest + 2, c);
+            _mm_stream_si128(p_dest + 3, d);
+        }
+        _mm_sfence();
+    }
+    for (; i + 64 <= size; i += 64)
+    {
+        const __m128i* p_src = (const __m128i*) (src + i);
+        __m128i a = _mm_loadu_si128(p_src);
+        __m128i b = _mm_loadu_si128(p_src + 1);
+        __m128i c = _mm_loadu_si128(p_src + 2);
+        __m128i d = _mm_loadu_si128(p_src + 3);
+        __m128i* p_dest = (__m128i*) (dest + i);
+        _mm_store_si128(p_dest, a);
+        _mm_store_si128(p_dest + 1, b);
+        _mm_store_si128(p_dest + 2, c);
+        _mm_store_si128(p_dest + 3, d);
+    }
+    for (; i + 16 <= size; i += 16)
+        _mm_store_si128((__m128i*) (dest + i),
+                        _mm_loadu_si128((const __m128i*) (src + i)));
+    _mm_storeu_si128((__m128i*) (dest + size - 16), tail);
+}
+
+__attribute__((target("sse2")))
+static void E_MoveForwardSSE2 (byte* dest, const byte* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        const __m128i* p_src = (const __m128i*) (src + i);
+        __m128i a = _mm_loadu_si128(p_src);
+        __m128i b = _mm_loadu_si128(p_src + 1);
+        __m128i c = _mm_loadu_si128(p_src + 2);
+        __m128i d = _mm_loadu_si128(p_src + 3);
+        __m128i* p_dest = (__m128i*) (dest + i);
+        _mm_storeu_si128(p_dest, a);
+        _mm_storeu_si128(p_dest + 1, b);
+        _mm_storeu_si128(p_dest + 2, c);
+        _mm_storeu_si128(p_dest + 3, d);
+    }
+    for (; i + 16 <= size; i += 16)
+        _mm_storeu_si128((__m128i*) (dest + i),
+                         _mm_loadu_si128((const __m128i*) (src + i)));
+    E_CopyWords(dest + i, src + i, size - i);
+}
+
+__attribute__((target("sse2")))
+static void E_MoveBackwardSSE2 (byte* dest, const byte* src, size_t size)
+{
+    for (; size >= 64; size -= 64)
+    {
+        const __m128i* p_src = (const __m128i*) (src + size - 64);
+        __m128i a = _mm_loadu_si128(p_src);
+        __m128i b = _mm_loadu_si128(p_src + 1);
+        __m128i c = _mm_loadu_si128(p_src + 2);
+        __m128i d = _mm_loadu_si128(p_src + 3);
+        __m128i* p_dest = (__m128i*) (dest + size - 64);
+        _mm_storeu_si128(p_dest + 3, d);
+        _mm_storeu_si128(p_dest + 2, c);
+        _mm_storeu_si128(p_dest + 1, b);
+        _mm_storeu_si128(p_dest, a);
+    }
+    for (; size >= 16; size -= 16)
+        _mm_storeu_si128((__m128i*) (dest + size - 16),
+                         _mm_loadu_si128((const __m128i*) (src + size - 16)));
+    E_CopyWordsBackward(dest, src, size);
+}
+
+__attribute__((target("sse2")))
+static void E_SetSSE2 (byte* dest, byte value, size_t size)
+{
+    if (size < 16) { E_SetWords(dest, value, size); return; }
+    __m128i fill = _mm_set1_epi8((char) value);
+    _mm_storeu_si128((__m128i*) dest, fill);
+    size_t i = 16 - ((size_t) dest & 15);
+    if (size >= E_STREAMMIN)
+    {
+        for (; i + 64 <= size; i += 64)
+        {
+            __m128i* p_dest = (__m128i*) (dest + i);
+            _mm_stream_si128(p_dest, fill);
+            _mm_stream_si128(p_dest + 1, fill);
+            _mm_stream_si128(p_dest + 2, fill);
+            _mm_stream_si128(p_dest + 3, fill);
+        }
+        _mm_sfence();
+    }
+    for (; i + 16 <= size; i += 16)
+        _mm_store_si128((__m128i*) (dest + i), fill);
+    _mm_storeu_si128((__m128i*) (dest + size - 16), fill);
+}
+
+/* AVX2: 32 bytes at a time, along the same lines as SSE2 */
+
+__attribute__((target("avx2")))
+static void E_CopyAVX2 (byte* dest, const byte* src, size_t size)
+{
+    if (size < 32) { E_CopySSE2(dest, src, size); return; }
+    __m256i tail = _mm256_loadu_si256((const __m256i*) (src + size - 32));
+    _mm256_storeu_si256((__m256i*) dest,
+                        _mm256_loadu_si256((const __m256i*) src));
+    size_t i = 32 - ((size_t) dest & 31);
+    if (size >= E_STREAMMIN)
+    {
+        for (; i + 128 <= size; i += 128)
+        {
+            const __m256i* p_src = (const __m256i*) (src + i);
+            __m256i a = _mm256_loadu_si256(p_src);
+            __m256i b = _mm256_loadu_si256(p_src + 1);
+            __m256i c = _mm256_loadu_si256(p_src + 2);
+            __m256i d = _mm256_loadu_si256(p_src + 3);
+            __m256i* p_dest = (__m256i*) (dest + i);
+            _mm256_stream_si256(p_dest, a);
+            _mm256_stream_si256(p_dest + 1, b);
+            _mm256_stream_si256(p_dest + 2, c);
+            _mm256_stream_si256(p_dest + 3, d);
+        }
+        _mm_sfence();
+    }
+    for (; i + 128 <= size; i += 128)
+    {
+        const __m256i* p_src = (const __m256i*) (src + i);
+        __m256i a = _mm256_loadu_si256(p_src);
+        __m256i b = _mm256_loadu_si256(p_src + 1);
+        __m256i c = _mm256_loadu_si256(p_src + 2);
+        __m256i d = _mm256_loadu_si256(p_src + 3);
+        __m256i* p_dest = (__m256i*) (dest + i);
+        _mm256_store_si256(p_dest, a);
+        _mm256_store_si256(p_dest + 1, b);
+        _mm256_store_si256(p_dest + 2, c);
+        _mm256_store_si256(p_dest + 3, d);
+    }
+    for (; i + 32 <= size; i += 32)
+        _mm256_store_si256((__m256i*) (dest + i),
+                           _mm256_loadu_si256((const __m256i*) (src + i)));
+    _mm256_storeu_si256((__m256i*) (dest + size - 32), tail);
+}
+
+__attribute__((target("avx2")))
+static void E_MoveForwardAVX2 (byte* dest, const byte* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128)
+    {
+        const __m256i* p_src = (const __m256i*) (src + i);
+        __m256i a = _mm256_loadu_si256(p_src);
+        __m256i b = _mm256_loadu_si256(p_src + 1);
+        __m256i c = _mm256_loadu_si256(p_src + 2);
+        __m256i d = _mm256_loadu_si256(p_src + 3);
+        __m256i* p_dest = (__m256i*) (dest + i);
+        _mm256_storeu_si256(p_dest, a);
+        _mm256_storeu_si256(p_dest + 1, b);
+        _mm256_storeu_si256(p_dest + 2, c);
+        _mm256_storeu_si256(p_dest + 3, d);
+    }
+    E_MoveForwardSSE2(dest + i, src + i, size - i);
+}
+
+__attribute__((target("avx2")))
+static void E_MoveBackwardAVX2 (byte* dest, const byte* src, size_t size)
+{
+    for (; size >= 128; size -= 128)
+    {
+        const __m256i* p_src = (const __m256i*) (src + size - 128);
+        __m256i a = _mm256_loadu_si256(p_src);
+        __m256i b = _mm256_loadu_si256(p_src + 1);
+        __m256i c = _mm256_loadu_si256(p_src + 2);
+        __m256i d = _mm256_loadu_si256(p_src + 3);
+        __m256i* p_dest = (__m256i*) (dest + size - 128);
+        _mm256_storeu_si256(p_dest + 3, d);
+        _mm256_storeu_si256(p_dest + 2, c);
+        _mm256_storeu_si256(p_dest + 1, b);
+        _mm256_storeu_si256(p_dest, a);
+    }
+    E_MoveBackwardSSE2(dest, src, size);
+}
+
+__attribute__((target("avx2")))
+static void E_SetAVX2 (byte* dest, byte value, size_t size)
+{
+    if (size < 32) { E_SetSSE2(dest, value, size); return; }
+    __m256i fill = _mm256_set1_epi8((char) value);
+    _mm256_storeu_si256((__m256i*) dest, fill);
+    size_t i = 32 - ((size_t) dest & 31);
+    if (size >= E_STREAMMIN)
+    {
+        for (; i + 128 <= size; i += 128)
+        {
+            __m256i* p_dest = (__m256i*) (dest + i);
+            _mm256_stream_si256(p_dest, fill);
+            _mm256_stream_si256(p_dest + 1, fill);
+            _mm256_stream_si256(p_dest + 2, fill);
+            _mm256_stream_si256(p_dest + 3, fill);
+        }
+        _mm_sfence();
+    }
+    for (; i + 32 <= size; i += 32)
+        _mm256_store_si256((__m256i*) (dest + i), fill);
+    _mm256_storeu_si256((__m256i*) (dest + size - 32), fill);
+}
+
+#endif
+
+int E_MemSupports (int impl)
+{
+    switch (impl)
+    {
+        case E_MEM_BYTE:
+        case E_MEM_WORD:
+            return 1;
+#ifdef E_X86
+        case E_MEM_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case E_MEM_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return 0;
+    }
+}
+
+int E_MemSelect (int impl)
+{
+    /* pick the widest implementation available */
+    if (impl == E_MEM_AUTO)
+    {
+        impl = E_MEM_AVX2;
+        while (!E_MemSupports(impl)) --impl;
+    }
+    if (!E_MemSupports(impl)) return -1;
+    switch (impl)
+    {
+        case E_MEM_BYTE:
+            p_copy = E_CopyBytes;
+            p_moveforward = E_CopyBytes;
+            p_movebackward = E_CopyBytesBackward;
+            p_set = E_SetBytes;
+            break;
+        case E_MEM_WORD:
+            p_copy = E_CopyWords;
+            p_moveforward = E_CopyWords;
+            p_movebackward = E_CopyWordsBackward;
+            p_set = E_SetWords;
+            break;
+#ifdef E_X86
+        case E_MEM_SSE2:
+            p_copy = E_CopySSE2;
+            p_moveforward = E_MoveForwardSSE2;
+            p_movebackward = E_MoveBackwardSSE2;
+            p_set = E_SetSSE2;
+            break;
+        case E_MEM_AVX2:
+            p_copy = E_CopyAVX2;
+            p_moveforward = E_MoveForwardAVX2;
+            p_movebackward = E_MoveBackwardAVX2;
+            p_set = E_SetAVX2;
+            break;
+#endif
+    }
+    return impl;
+}
+
+/* copies `size` bytes from `src` to `dest`, which must not overlap */
+void E_Memcpy (void* dest, void* src, size_t size)
+{
+    if (!p_copy) E_MemSelect(E_MEM_AUTO);
+    p_copy((byte*) dest, (const byte*) src, size);
+}
+
+/* copies `size` bytes from `src` to `dest`, which may overlap */
+void E_Memmove (void* dest, void* src, size_t size)
+{
+    if (!p_copy) E_MemSelect(E_MEM_AUTO);
+    if ((byte*) dest <= (byte*) src) p_moveforward(dest, src, size);
+    else p_movebackward(dest, src, size);
+}
+
+void E_Memset (void* dest, int value, size_t size)
+{
+    if (!p_set) E_MemSelect(E_MEM_AUTO);
+    p_set((byte*) dest, (byte) value, size);
+}
@@ -0,0 +1,46 @@
+/*
+ *  e_memcpy.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      Routines to copy and fill memory, used by the custom memory allocator
+ *      and its clients.
+ *
+ *      `E_Memcpy` and `E_Memset` move whole words, or whole SSE2/AVX2
+ *      registers where the CPU supports them, rather than single bytes. Very
+ *      big copies are written around the caches with non-temporal stores.
+ *      `E_Memmove` is the variant of `E_Memcpy` that is safe to use on
+ *      overlapping regions.
+ *
+ *      The widest implementation available is picked on first use. A specific
+ *      one can be forced with `E_MemSelect`, e.g., to benchmark them against
+ *      each other.
+ */
+
+#ifndef e_memcpy_h
+
+#include "t_typedef.h"
+
+#define e_memcpy_h
+#define e_memcpy_h_E_MemSupports E_MemSupports
+#define e_memcpy_h_E_MemSelect E_MemSelect
+#define e_memcpy_h_E_Memcpy E_Memcpy
+#define e_memcpy_h_E_Memmove E_Memmove
+#define e_memcpy_h_E_Memset E_Memset
+
+/* implementations for `E_MemSelect`, from the narrowest to the widest */
+#define E_MEM_AUTO -1 // the widest one the CPU supports
+#define E_MEM_BYTE 0
+#define E_MEM_WORD 1
+#define E_MEM_SSE2 2
+#define E_MEM_AVX2 3
+
+int E_MemSupports (int impl);
+int E_MemSelect (int impl);
+void E_Memcpy (void* dest, void* src, size_t size);
+void E_Memmove (void* dest, void* src, size_t size);
+void E_Memset (void* dest, int value, size_t size);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ *  e_slab.c
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      A slab allocator for objects of a single, fixed size, e.g., the nodes of
+ *      a container, built on top of the custom memory allocator.
+ */
+
+#include <stdio.h>
+
+#include "t_typedef.h"
+#include "e_malloc.h"
+#include "e_slab.h"
+
+// each slab, along with the header of its block, takes up exactly a page
+#define E_PAGESIZE 4096
+
+typedef struct slabpage {
+    struct slabpage* p_next;
+} E_SlabPage;
+
+struct slab {
+    size_t objsize, objsperpage;
+    E_SlabPage* p_pages;
+    void* p_free; // intrusive list of the free objects, linked through their
+                  // first word
+    size_t numpages, numlive;
+};
+
+static const size_t SIZE_PAGEHEADER = (sizeof(E_SlabPage) + 7) >> 3 << 3;
+static const size_t SIZE_PAGE = E_PAGESIZE - sizeof(E_Memblock);
+
+E_Slab* E_SlabCreate (size_t objsize)
+{
+    // room for the free list link, and 8-byte aligned like `E_Malloc`
+    if (objsize < sizeof(void*)) objsize = sizeof(void*);
+    objsize = (objsize + 7) >> 3 << 3;
+    if (objsize > SIZE_PAGE - SIZE_PAGEHEADER)
+    {
+        printf("E_SlabCreate: Objects too big for a slab.\n");
+        return NULL;
+    }
+    E_Slab* p_slab = (E_Slab*) E_Malloc(sizeof(E_Slab), E_SlabCreate);
+    if (!p_slab) return NULL;
+    p_slab->objsize = objsize;
+    p_slab->objsperpage = (SIZE_PAGE - SIZE_PAGEHEADER) / objsize;
+    p_slab->p_pages = NULL;
+    p_slab->p_free = NULL;
+    p_slab->numpages = 0;
+    p_slab->numlive = 0;
+    return p_slab;
+}
+
+void E_SlabDestroy (E_Slab* p_slab)
+{
+    if (!p_slab) return;
+    E_SlabPage* p_page = p_slab->p_pages;
+    while (p_page)
+    {
+        E_SlabPage* p_next = p_page->p_next;
+        E_Free(p_page);
+        p_page = p_next;
+    }
+    E_Free(p_slab);
+}
+
+/* maps a new page, and threads all of its objects onto the free list */
+static int E_SlabGrow (E_Slab* p_slab)
+{
+    E_SlabPage* p_page = (E_SlabPage*) E_Malloc(SIZE_PAGE, p_slab);
+    if (!p_page) return 0;
+    p_page->p_next = p_slab->p_pages;
+    p_slab->p_pages = p_page;
+    ++p_slab->numpages;
+    byte* p_objs = (byte*) p_page + SIZE_PAGEHEADER;
+    // thread them backwards, so they are handed out in address order
+    for (size_t i = p_slab->objsperpage; i-- > 0;)
+    {
+        void** p_obj = (void**) (p_objs + i * p_slab->objsize);
+        *p_obj = p_slab->p_free;
+        p_slab->p_free = p_obj;
+    }
+    return 1;
+}
+
+void* E_SlabAlloc (E_Slab* p_slab)
+{
+    if (!p_slab->p_free && !E_SlabGrow(p_slab))
+    {
+        printf("E_SlabAlloc: Insufficient memory.\n");
+        return NULL;
+    }
+    void** p_obj = (void**) p_slab->p_free;
+    p_slab->p_free = *p_obj;
+    ++p_slab->numlive;
+    return p_obj;
+}
+
+void E_SlabFree (E_Slab* p_slab, void* ptr)
+{
+    if (!ptr) return;
+    *((void**) ptr) = p_slab->p_free;
+    p_slab->p_free = ptr;
+    --p_slab->numlive;
+}
+
+size_t E_SlabObjSize (E_Slab* p_slab)
+{
+    return p_slab->objsize;
+}
+
+void E_SlabDump (E_Slab* p_slab)
+{
+    size_t footprint = p_slab->numpages * E_PAGESIZE;
+    printf("Slab dump @%p: %zuB objects, %zu page(s), %zu object(s) live\n",
+           (byte*) p_slab, p_slab->objsize, p_slab->numpages,
+           p_slab->numlive);
+    if (p_slab->numlive)
+        printf("Footprint: %zuBs, %.2fB per live object\n", footprint,
+               (double) footprint / p_slab->numlive);
+}
@@ -0,0 +1,43 @@
+/*
+ *  e_slab.h
+ *  algos
+ *
+ *  Created by Emre Akı on 2026-10-17.
+ *
+ *  SYNOPSIS:
+ *      A slab allocator for objects of a single, fixed size, e.g., the nodes of
+ *      a container, built on top of the custom memory allocator.
+ *
+ *      Objects are carved out of page-sized slabs, each of which is a single
+ *      block from `E_Malloc`, so they don't pay for a block header of their
+ *      own. Freed objects are kept in an intrusive free list, and handed out
+ *      again in O(1). Slabs are only given back to the allocator when the
+ *      whole thing is destroyed with `E_SlabDestroy`.
+ *
+ *      A slab allocator is not guarded by a lock, so it should not be shared
+ *      between threads.
+ */
+
+#ifndef e_slab_h
+
+#include "t_typedef.h"
+
+#define e_slab_h
+#define e_slab_h_E_Slab E_Slab
+#define e_slab_h_E_SlabCreate E_SlabCreate
+#define e_slab_h_E_SlabDestroy E_SlabDestroy
+#define e_slab_h_E_SlabAlloc E_SlabAlloc
+#define e_slab_h_E_SlabFree E_SlabFree
+#define e_slab_h_E_SlabObjSize E_SlabObjSize
+#define e_slab_h_E_SlabDump E_SlabDump
+
+typedef struct slab E_Slab;
+
+E_Slab* E_SlabCreate (size_t objsize);
+void E_SlabDestroy (E_Slab* p_slab);
+void* E_SlabAlloc (E_Slab* p_slab);
+void E_SlabFree (E_Slab* p_slab, void* ptr);
+size_t E_SlabObjSize (E_Slab* p_slab);
+void E_SlabDump (E_Slab* p_slab);
+
+#endif
@@ -10,10 +10,13 @@
  */
 
 #include <stdio.h>
-#include <math.h>
 
+#include "e_malloc.h"
 #include "h_heap.h"
 
+// the handle given back after `handle`, chained through the slots
+#define H_NEXTFREE(p_queue, handle) (-2 - *((p_queue)->slots + (handle)))
+
 static void H_Swap (HeapNode* heap, int i, int j)
 {
     HeapNode aux = *(heap + i);
@@ -23,7 +26,7 @@ static void H_Swap (HeapNode* heap, int i, int j)
 
 static int H_Parent (int index)
 {
-    return ceil((index * 0.5) - 1);
+    return (index - 1) >> 1;
 }
 
 static int H_Child (int index, int right)
@@ -31,21 +34,40 @@ static int H_Child (int index, int right)
     return (index << 1) + right + 1;
 }
 
-void H_Heapify (HeapNode* raw, HeapNode* heap, int size)
+/* bubbles the node at `self` down until neither of its children has higher
+ * priority, moving the children up into the hole it leaves instead of
+ * swapping them
+ */
+static void H_SiftDown (HeapNode* heap, int self, int size)
 {
-    for (int i = 0; i < size; ++i)
+    HeapNode node = *(heap + self);
+    int child;
+    while ((child = H_Child(self, 0)) < size)
     {
-        *(heap + i) = *(raw + i);
-        int key = (heap + i)->key;
-        int self = i, parent = H_Parent(self);
-        /* bubble-up procedure */
-        while (parent >= 0 && (heap + parent)->key < key)
-        {
-            H_Swap(heap, parent, self);
-            self = parent;
-            parent = H_Parent(self);
-        }
+        // the right child wins the ties, as in `H_HeapPop`
+        if (child + 1 < size && (heap + child + 1)->key >= (heap + child)->key)
+            ++child;
+        if (node.key >= (heap + child)->key) break;
+        *(heap + self) = *(heap + child);
+        self = child;
     }
+    *(heap + self) = node;
+}
+
+/* heapifies `raw` in place, in `O(n)`: every subtree is a heap once its root
+ * is sifted down, so the nodes are sifted down from the last parent back to
+ * the root–most of them sit near the bottom, with little room to sink
+ */
+void H_HeapifyInPlace (HeapNode* raw, int size)
+{
+    for (int i = H_Parent(size - 1); i >= 0; --i) H_SiftDown(raw, i, size);
+}
+
+void H_Heapify (HeapNode* raw, HeapNode* heap, int size)
+{
+    if (size <= 0) return;
+    E_Memcpy(heap, raw, sizeof(HeapNode) * size);
+    H_HeapifyInPlace(heap, size);
 }
 
 HeapNode H_HeapPop (HeapNode* heap, int* size)
@@ -104,6 +126,157 @@ HeapNode H_HeapPop (HeapNode* heap, int* size)
     return popped;
 }
 
+/* moves the node at `from` in the heap of the queue over to `to`, keeping the
+ * slot of its handle up to date
+ */
+static void H_QueueMove (H_Queue* p_queue, int from, int to)
+{
+    *(p_queue->heap + to) = *(p_queue->heap + from);
+    *(p_queue->handles + to) = *(p_queue->handles + from);
+    *(p_queue->slots + *(p_queue->handles + to)) = to;
+}
+
+static void H_QueuePlace (H_Queue* p_queue, HeapNode node, int handle,
+                          int self)
+{
+    *(p_queue->heap + self) = node;
+    *(p_queue->handles + self) = handle;
+    *(p_queue->slots + handle) = self;
+}
+
+static void H_QueueSiftUp (H_Queue* p_queue, int self)
+{
+    HeapNode node = *(p_queue->heap + self);
+    int handle = *(p_queue->handles + self);
+    while (self > 0)
+    {
+        int parent = H_Parent(self);
+        if ((p_queue->heap + parent)->key >= node.key) break;
+        H_QueueMove(p_queue, parent, self);
+        self = parent;
+    }
+    H_QueuePlace(p_queue, node, handle, self);
+}
+
+static void H_QueueSiftDown (H_Queue* p_queue, int self)
+{
+    HeapNode* heap = p_queue->heap;
+    HeapNode node = *(heap + self);
+    int handle = *(p_queue->handles + self);
+    int size = p_queue->size, child;
+    while ((child = H_Child(self, 0)) < size)
+    {
+        if (child + 1 < size && (heap + child + 1)->key >= (heap + child)->key)
+            ++child;
+        if (node.key >= (heap + child)->key) break;
+        H_QueueMove(p_queue, child, self);
+        self = child;
+    }
+    H_QueuePlace(p_queue, node, handle, self);
+}
+
+H_Queue* H_QueueInit (int capacity)
+{
+    if (capacity < H_MINCAPACITY) capacity = H_MINCAPACITY;
+    H_Queue* p_queue = (H_Queue*) E_Malloc(sizeof(H_Queue), H_QueueInit);
+    p_queue->heap = (HeapNode*) E_Malloc(sizeof(HeapNode) * capacity,
+                                         H_QueueInit);
+    p_queue->handles = (int*) E_Malloc(sizeof(int) * capacity, H_QueueInit);
+    p_queue->slots = (int*) E_Malloc(sizeof(int) * capacity, H_QueueInit);
+    p_queue->size = 0;
+    p_queue->capacity = capacity;
+    p_queue->numhandles = 0;
+    p_queue->freehandle = -1;
+    return p_queue;
+}
+
+/* pushes a node in `O(log n)`, doubling the storage when it's full, and
+ * returns the handle to find it again with, which stays the same for as long
+ * as the node is in the queue–the handles of the popped nodes are reused
+ */
+int H_Push (H_Queue* p_queue, int data, int key)
+{
+    if (p_queue->size == p_queue->capacity)
+    {
+        int capacity = p_queue->capacity << 1;
+        p_queue->heap = (HeapNode*) E_Realloc(p_queue->heap,
+                                              sizeof(HeapNode) * capacity);
+        p_queue->handles = (int*) E_Realloc(p_queue->handles,
+                                            sizeof(int) * capacity);
+        p_queue->slots = (int*) E_Realloc(p_queue->slots,
+                                          sizeof(int) * capacity);
+        p_queue->capacity = capacity;
+    }
+    /* there are never more handles than the queue can hold nodes, as a new
+     * one is only given out when all the others are in use
+     */
+    int handle = p_queue->freehandle;
+    if (handle >= 0) p_queue->freehandle = H_NEXTFREE(p_queue, handle);
+    else handle = p_queue->numhandles++;
+    int self = p_queue->size++;
+    HeapNode node = { data, key };
+    H_QueuePlace(p_queue, node, handle, self);
+    H_QueueSiftUp(p_queue, self);
+    return handle;
+}
+
+/* the node with the highest priority, or NULL if the queue is empty */
+HeapNode* H_Peek (H_Queue* p_queue)
+{
+    return p_queue->size ? p_queue->heap : NULL;
+}
+
+HeapNode H_Pop (H_Queue* p_queue)
+{
+    HeapNode popped = { 0, 0 };
+    if (!p_queue->size)
+    {
+        printf("H_Pop: The queue is empty.\n");
+        return popped;
+    }
+    popped = *p_queue->heap;
+    /* give the handle back, chaining it to the other free ones through its
+     * slot
+     */
+    int handle = *p_queue->handles;
+    *(p_queue->slots + handle) = -2 - p_queue->freehandle;
+    p_queue->freehandle = handle;
+    if (--p_queue->size)
+    {
+        H_QueueMove(p_queue, p_queue->size, 0);
+        H_QueueSiftDown(p_queue, 0);
+    }
+    return popped;
+}
+
+/* changes the key of the node with the given handle in `O(log n)`, bubbling
+ * it up or down depending on which way the key went
+ */
+void H_UpdateKey (H_Queue* p_queue, int handle, int key)
+{
+    if (handle < 0 || handle >= p_queue->numhandles ||
+        *(p_queue->slots + handle) < 0)
+    {
+        printf("H_UpdateKey: Handle %d is not in the queue.\n", handle);
+        return;
+    }
+    int self = *(p_queue->slots + handle);
+    HeapNode* p_node = p_queue->heap + self;
+    int oldkey = p_node->key;
+    p_node->key = key;
+    if (key > oldkey) H_QueueSiftUp(p_queue, self);
+    else if (key < oldkey) H_QueueSiftDown(p_queue, self);
+}
+
+void H_QueueDestroy (H_Queue* p_queue)
+{
+    if (!p_queue) return;
+    E_Free(p_queue->heap);
+    E_Free(p_queue->handles);
+    E_Free(p_queue->slots);
+    E_Free(p_queue);
+}
+
 void H_PrintHeap (HeapNode* heap, int size)
 {
     printf("Priority queue @%p:\n\n", heap);
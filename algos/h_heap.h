@@ -7,6 +7,13 @@
  *  SYNOPSIS:
  *      A simple priority-queue (max-heap) implementation that supports
  *      integer (i32) keys and values.
+ *
+ *      The heap is built bottom-up in `O(n)`, either into a second array with
+ *      `H_Heapify`, or in place with `H_HeapifyInPlace`.
+ *
+ *      For a queue that changes over time, `H_Queue` grows its storage as
+ *      nodes are pushed, and hands out a handle for each, with which its key
+ *      can later be changed with `H_UpdateKey`, in `O(log n)`.
  */
 
 #ifndef h_heap_h
@@ -14,16 +21,47 @@
 #define h_heap_h
 #define h_heap_h_HeapNode HeapNode
 #define h_heap_h_H_Heapify H_Heapify
+#define h_heap_h_H_HeapifyInPlace H_HeapifyInPlace
 #define h_heap_h_H_HeapPop H_HeapPop
+#define h_heap_h_H_Queue H_Queue
+#define h_heap_h_H_QueueInit H_QueueInit
+#define h_heap_h_H_Push H_Push
+#define h_heap_h_H_Peek H_Peek
+#define h_heap_h_H_Pop H_Pop
+#define h_heap_h_H_UpdateKey H_UpdateKey
+#define h_heap_h_H_QueueDestroy H_QueueDestroy
 #define h_heap_h_H_PrintHeap H_PrintHeap
 
+// the least number of nodes a queue has room for
+#define H_MINCAPACITY 16
+
 typedef struct {
     int data;
     int key;
 } HeapNode;
 
+/* a heap that grows as needed, which keeps track of where each of its nodes
+ * is, so that the key of any of them can be changed, see `H_Push`
+ */
+typedef struct {
+    HeapNode* heap;
+    int* handles; // the handle of each node in the heap
+    int* slots; // where the node of each handle is in the heap, if it is
+    int size;
+    int capacity;
+    int numhandles; // the handles given out so far, in use or not
+    int freehandle; // the last handle given back, -1 if there's none
+} H_Queue;
+
 void H_Heapify (HeapNode* raw, HeapNode* heap, int size);
+void H_HeapifyInPlace (HeapNode* raw, int size);
 HeapNode H_HeapPop (HeapNode* heap, int* size);
+H_Queue* H_QueueInit (int capacity);
+int H_Push (H_Queue* p_queue, int data, int key);
+HeapNode* H_Peek (H_Queue* p_queue);
+HeapNode H_Pop (H_Queue* p_queue);
+void H_UpdateKey (H_Queue* p_queue, int handle, int key);
+void H_QueueDestroy (H_Queue* p_queue);
 void H_PrintHeap (HeapNode* heap, int size);
 
 #endif
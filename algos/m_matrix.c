@@ -14,9 +14,23 @@
 #include <stdio.h>
 
 #include "e_malloc.h"
+#include "e_arena.h"
 #include "m_matrix.h"
 #include "u_math.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#define M_X86
+#include <immintrin.h>
+#endif
+
+// align the matrices to a cache line, which is wide enough for any SIMD load
+static const size_t M_ALIGNMENT = 64;
+
+typedef double (*M_DotFunc) (double* vector0, double* vector1,
+                             int dimensions);
+
+static M_DotFunc p_dot = NULL;
+
 static double M_Get (double* matrix, int cols, int r, int c)
 {
     return *(matrix + (cols * r + c));
@@ -33,18 +47,24 @@ static double* M_SafeError (double* matrix)
     return NULL;
 }
 
-double* M_Transpose (double* matrix, int rows, int cols)
+static void M_Transpose_ (double* matrix, int rows, int cols,
+                          double* transposed)
 {
-    // allocate new memory for the transposed matrix
-    double* transposed = E_Malloc(sizeof(double) * rows * cols, M_Transpose);
-    /* transpose matrix */
     for (int r = 0; r < rows; ++r)
         for (int c = 0; c < cols; ++c)
             M_Set(transposed, M_Get(matrix, cols, r, c), rows, c, r);
+}
+
+double* M_Transpose (double* matrix, int rows, int cols)
+{
+    // allocate new memory for the transposed matrix
+    double* transposed = E_MallocAligned(sizeof(double) * rows * cols,
+                                         M_ALIGNMENT, M_Transpose);
+    M_Transpose_(matrix, rows, cols, transposed);
     return transposed;
 }
 
-double M_Dot (double* vector0, double* vector1, int dimensions)
+static double M_DotScalar (double* vector0, double* vector1, int dimensions)
 {
     double sum = 0;
     for (int d = 0; d < dimensions; ++d)
@@ -52,6 +72,75 @@ double M_Dot (double* vector0, double* vector1, int dimensions)
     return sum;
 }
 
+#ifdef M_X86
+
+/* AVX2: 8 doubles at a time, in two independent sums
+ *
+ * steps through a scalar head until `vector1` reaches a 32 byte boundary,
+ * which the rows of our transposed matrices already sit on, and then loads
+ * it with aligned loads. `vector0` gets aligned loads as well when it is
+ * equally far off a boundary, and unaligned ones otherwise
+ */
+__attribute__((target("avx2")))
+static double M_DotAVX2 (double* vector0, double* vector1, int dimensions)
+{
+    double sum = 0;
+    int d = 0;
+    for (; d < dimensions && ((size_t) (vector1 + d) & 31); ++d)
+        sum += (*(vector0 + d)) * (*(vector1 + d));
+    __m256d a = _mm256_setzero_pd();
+    __m256d b = _mm256_setzero_pd();
+    if (!((size_t) (vector0 + d) & 31))
+    {
+        for (; d + 8 <= dimensions; d += 8)
+        {
+            a = _mm256_add_pd(a, _mm256_mul_pd(_mm256_load_pd(vector0 + d),
+                                               _mm256_load_pd(vector1 + d)));
+            b = _mm256_add_pd(b,
+                              _mm256_mul_pd(_mm256_load_pd(vector0 + d + 4),
+                                            _mm256_load_pd(vector1 + d + 4)));
+        }
+    }
+    else
+    {
+        for (; d + 8 <= dimensions; d += 8)
+        {
+            a = _mm256_add_pd(a, _mm256_mul_pd(_mm256_loadu_pd(vector0 + d),
+                                               _mm256_load_pd(vector1 + d)));
+            b = _mm256_add_pd(b,
+                              _mm256_mul_pd(_mm256_loadu_pd(vector0 + d + 4),
+                                            _mm256_load_pd(vector1 + d + 4)));
+        }
+    }
+    a = _mm256_add_pd(a, b);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(a),
+                              _mm256_extractf128_pd(a, 1));
+    sum += _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; d < dimensions; ++d)
+        sum += (*(vector0 + d)) * (*(vector1 + d));
+    return sum;
+}
+
+#endif
+
+/* picks the widest inner product the CPU supports */
+static M_DotFunc M_SelectDot (void)
+{
+#ifdef M_X86
+    if (__builtin_cpu_supports("avx2")) p_dot = M_DotAVX2;
+    else p_dot = M_DotScalar;
+#else
+    p_dot = M_DotScalar;
+#endif
+    return p_dot;
+}
+
+double M_Dot (double* vector0, double* vector1, int dimensions)
+{
+    M_DotFunc dot = p_dot ? p_dot : M_SelectDot();
+    return dot(vector0, vector1, dimensions);
+}
+
 double* M_Mult (double* left, int leftrows, int leftcols,
                 double* right, int rightrows, int rightcols)
 {
@@ -61,9 +150,20 @@ double* M_Mult (double* left, int leftrows, int leftcols,
         return NULL;
     }
     // allocate new memory for the resulting matrix
-    double* result = E_Malloc(sizeof(double) * leftrows * rightcols, M_Mult);
-    // transpose the right matrix to leverage CPU cache-hits
-    double* transposed = M_Transpose(right, rightrows, rightcols);
+    double* result = E_MallocAligned(sizeof(double) * leftrows * rightcols,
+                                     M_ALIGNMENT, M_Mult);
+    // transpose the right matrix to leverage CPU cache-hits, into the scratch
+    // arena as it is only needed until we're done
+    E_ArenaMark_t mark = E_ArenaMark();
+    double* transposed = E_ArenaAllocAligned(sizeof(double) * rightrows *
+                                             rightcols, M_ALIGNMENT);
+    if (!transposed)
+    {
+        E_ArenaRelease(mark);
+        return M_SafeError(result);
+    }
+    M_Transpose_(right, rightrows, rightcols, transposed);
+    M_DotFunc dot = p_dot ? p_dot : M_SelectDot();
     /* multiply matrices */
     for (int r = 0; r < leftrows; ++r)
     {
@@ -72,26 +172,23 @@ double* M_Mult (double* left, int leftrows, int leftcols,
         {
             int rightoffset = c * rightrows;
             M_Set(result,
-                  M_Dot(left + leftoffset, transposed + rightoffset, leftcols),
+                  dot(left + leftoffset, transposed + rightoffset, leftcols),
                   rightcols, r, c);
         }
     }
-    E_Free(transposed);
+    E_ArenaRelease(mark);
     return result;
 }
 
-double* M_ToRREF (double* matrix, int rows, int cols, int delimiter)
+/* row reduces the matrix in place, returning 0 if it turns out to be
+ * non-invertible
+ */
+static int M_Reduce (double* rref, int rows, int cols, int delimiter)
 {
-    int sizebytes = sizeof(double) * rows * cols;
-    // allocate new memory for the row reduced matrix
-    double* rref = E_Malloc(sizebytes, M_ToRREF);
-    // clone the original matrix to the new one for processing
-    E_Memcpy(rref, matrix, sizebytes);
-    /* row reduction */
     int cpivot = 0;
     for (int r = 0; r < rows; ++r)
     {
-        if (cpivot == delimiter) return M_SafeError(rref);
+        if (cpivot == delimiter) return 0;
         int rpivot = r;
         /* find pivot */
         while(!M_Get(rref, cols, rpivot, cpivot))
@@ -100,7 +197,7 @@ double* M_ToRREF (double* matrix, int rows, int cols, int delimiter)
              * this means the matrix is non-invertible, so return immediately
              */
             if (rpivot == rows - 1 && cpivot == delimiter - 1)
-                return M_SafeError(rref);
+                return 0;
             // the column has no non-zero entries, advance to the next one
             else if (rpivot == rows - 1) { ++cpivot; rpivot = r; }
             // look for a pivot in the row below in the current column
@@ -145,14 +242,32 @@ double* M_ToRREF (double* matrix, int rows, int cols, int delimiter)
         }
         ++cpivot; // done reducing the current column, advance to the next
     }
+    return 1;
+}
+
+double* M_ToRREF (double* matrix, int rows, int cols, int delimiter)
+{
+    int sizebytes = sizeof(double) * rows * cols;
+    // allocate new memory for the row reduced matrix
+    double* rref = E_Malloc(sizebytes, M_ToRREF);
+    // clone the original matrix to the new one for processing
+    E_Memcpy(rref, matrix, sizebytes);
+    if (!M_Reduce(rref, rows, cols, delimiter)) return M_SafeError(rref);
     return rref;
 }
 
 double* M_Invert (double* matrix, int rows)
 {
     int cols = rows + rows;
-    // allocate new memory for the augmented matrix for it to be row reduced
-    double* augmented = E_Malloc(sizeof(double) * rows * cols , M_Invert);
+    // allocate scratch memory for the augmented matrix to be row reduced in
+    // place
+    E_ArenaMark_t mark = E_ArenaMark();
+    double* augmented = E_ArenaAlloc(sizeof(double) * rows * cols);
+    if (!augmented)
+    {
+        E_ArenaRelease(mark);
+        return NULL;
+    }
     /* create an augmented matrix for inversion */
     for (int r = 0; r < rows; ++r)
     {
@@ -163,15 +278,19 @@ double* M_Invert (double* matrix, int rows)
             else M_Set(augmented, M_Get(matrix, rows, r, c), cols, r, c);
         }
     }
-    double* rref = M_ToRREF(augmented, rows, cols, rows);
+    if (!M_Reduce(augmented, rows, cols, rows))
+    {
+        E_ArenaRelease(mark);
+        printf("M_Invert: Matrix is not invertible.\n");
+        return NULL;
+    }
     // allocate new memory for the inverted matrix
     double* inverted = E_Malloc(sizeof(double) * rows * rows , M_Invert);
     /* extract the inverted matrix from the rref'ed augmented matrix */
     for (int r = 0; r < rows; ++r)
         for (int c = 0; c < rows; ++c)
-            M_Set(inverted, M_Get(rref, cols, r, rows + c), rows, r, c);
-    E_Free(augmented);
-    E_Free(rref);
+            M_Set(inverted, M_Get(augmented, cols, r, rows + c), rows, r, c);
+    E_ArenaRelease(mark);
     return inverted;
 }
 
@@ -9,10 +9,14 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "e_malloc.h"
+#include "e_slab.h"
+#include "e_arena.h"
 #include "d_disjointset.h"
 #include "a_avl.h"
+#include "a_avlmap.h"
 #include "m_matrix.h"
 #include "m_fixed.h"
 #include "m_lookat.h"
@@ -25,12 +29,240 @@
 #include "dp_dynprog.h"
 #include "sr_sort.h"
 #include "s_buffer.h"
+#include "b_emalloc.h"
+#include "b_avl.h"
+#include "b_heap.h"
+
+void TestZone (void)
+{
+    E_Zone* p_zone = E_ZoneCreate(1, E_ZONE_GROWABLE);
+    int* p_ints = (int*) E_ZoneMalloc(p_zone, sizeof(int) * 16, TestZone);
+    double* p_doubles = (double*) E_ZoneMalloc(p_zone, sizeof(double) * 4,
+                                               TestZone);
+    p_ints = (int*) E_ZoneRealloc(p_zone, p_ints, sizeof(int) * 32);
+    E_ZoneFree(p_zone, p_doubles);
+    // does not fit in the initial 1MiBs, so the zone should grow by a chunk
+    byte* p_bytes = (byte*) E_ZoneMalloc(p_zone, 3 << 20, TestZone);
+    *(p_bytes + (3 << 20) - 1) = 0xff;
+    E_ZoneDump(p_zone);
+    // the default zone should remain untouched
+    E_Dump();
+    // throw away the zone, along with `p_ints`, all at once
+    E_ZoneDestroy(p_zone);
+}
+
+void TestAlignedAlloc (void)
+{
+    void* p_blocks[4];
+    size_t alignment = 16;
+    for (int i = 0; i < 4; ++i, alignment <<= 1)
+    {
+        p_blocks[i] = E_MallocAligned(24, alignment, TestAlignedAlloc);
+        printf("%p aligned to %zuBs: %d\n", p_blocks[i], alignment,
+               !((size_t) p_blocks[i] & (alignment - 1)));
+    }
+    // grow the 32-byte-aligned block past its free neighbour, so it has to
+    // move
+    p_blocks[1] = E_ReallocAligned(p_blocks[1], 4096, 32);
+    printf("%p aligned to 32Bs after realloc: %d\n", p_blocks[1],
+           !((size_t) p_blocks[1] & 31));
+    E_Dump();
+    for (int i = 0; i < 4; ++i) E_Free(p_blocks[i]);
+    E_Dump();
+}
+
+void TestMemcpy (void)
+{
+    const char* implnames[] = { "byte", "word", "SSE2", "AVX2" };
+    const int bufsize = 1024;
+    byte* p_buf = (byte*) E_Malloc(bufsize, TestMemcpy);
+    byte* p_expected = (byte*) E_Malloc(bufsize, TestMemcpy);
+    for (int impl = E_MEM_BYTE; impl <= E_MEM_AVX2; ++impl)
+    {
+        if (E_MemSelect(impl) < 0) continue;
+        int mismatches = 0;
+        // odd sizes and offsets, with the source and the destination
+        // overlapping in either direction for `E_Memmove`
+        for (int size = 0; size < 300; size += 7)
+        {
+            for (int offset = 0; offset < 40; offset += 3)
+            {
+                int src = 128 + offset % 17, dest = 128 + offset - 20;
+                for (int i = 0; i < bufsize; ++i) *(p_buf + i) = (byte) i;
+                memcpy(p_expected, p_buf, bufsize);
+                memmove(p_expected + dest, p_expected + src, size);
+                E_Memmove(p_buf + dest, p_buf + src, size);
+                mismatches += !!memcmp(p_buf, p_expected, bufsize);
+                memcpy(p_expected + 600 + offset, p_expected + src, size);
+                E_Memcpy(p_buf + 600 + offset, p_buf + src, size);
+                mismatches += !!memcmp(p_buf, p_expected, bufsize);
+                memset(p_expected + offset, size, size);
+                E_Memset(p_buf + offset, size, size);
+                mismatches += !!memcmp(p_buf, p_expected, bufsize);
+            }
+        }
+        printf("E_Memcpy/E_Memmove/E_Memset (%s): %d mismatch(es)\n",
+               implnames[impl], mismatches);
+    }
+    E_MemSelect(E_MEM_AUTO);
+    E_Free(p_buf);
+    E_Free(p_expected);
+}
+
+void TestSlab (void)
+{
+    E_Slab* p_slab = E_SlabCreate(sizeof(AVL_Node));
+    AVL_Tree* p_tree = AVL_InitTree();
+    AVL_UseSlab(p_tree, p_slab);
+    for (int i = 0; i < 200; ++i) AVL_Push(p_tree, (i * 37) % 200);
+    printf("AVL_Depth: %d\n", AVL_Depth(p_tree));
+    E_SlabDump(p_slab);
+    AVL_Destroy(p_tree);
+    E_SlabDump(p_slab);
+    // the free objects are handed out again, without growing the slab
+    queue_t* queue = Q_Init();
+    Q_UseSlab(queue, p_slab);
+    for (int i = 0; i < 100; ++i) Q_Push(queue, NULL);
+    E_SlabDump(p_slab);
+    Q_Destroy(queue);
+    E_SlabDestroy(p_slab);
+    E_Dump();
+}
+
+void TestProfile (void)
+{
+    E_Profiling(1);
+    queue_t* queue = Q_Init();
+    for (int i = 0; i < 8; ++i) Q_Push(queue, NULL);
+    for (int i = 0; i < 6; ++i) Q_Pop(queue);
+    double* p_doubles = (double*) E_Malloc(sizeof(double) * 4, TestProfile);
+    p_doubles = (double*) E_Realloc(p_doubles, sizeof(double) * 64);
+    E_Free(p_doubles);
+    printf("Q_Init: %p, TestProfile: %p\n", (void*) Q_Init,
+           (void*) TestProfile);
+    E_Profile();
+    E_ProfileDump(NULL);
+    Q_Destroy(queue);
+    E_Profiling(0);
+    // a block from an earlier session is left out of the new one
+    p_doubles = (double*) E_Malloc(100, TestProfile);
+    E_Profiling(1);
+    E_Free(p_doubles);
+    E_Free(E_Malloc(16, TestProfile));
+    E_Profile();
+    E_Profiling(0);
+}
+
+void TestTags (void)
+{
+    int* p_kept[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        p_kept[i] = (int*) E_Malloc(sizeof(int) * 4, TestTags);
+        // scratch blocks in between the ones to be kept
+        E_MallocTag(sizeof(int) * (i + 1), E_TAG_SCRATCH, TestTags);
+        E_MallocTag(sizeof(int) * 8, E_TAG_SCRATCH + 1, TestTags);
+    }
+    E_Dump();
+    printf("E_FreeTags: %zu block(s) freed\n",
+           E_FreeTags(E_TAG_SCRATCH, E_TAG_SCRATCH + 1));
+    E_Dump();
+    for (int i = 0; i < 4; ++i) E_Free(p_kept[i]);
+}
+
+void TestArena (void)
+{
+    E_ArenaMark_t outer = E_ArenaMark();
+    int* p_ints = (int*) E_ArenaAlloc(sizeof(int) * 3);
+    double* p_doubles = (double*) E_ArenaAllocAligned(sizeof(double) * 8, 64);
+    printf("%p aligned to 64Bs: %d\n", (void*) p_doubles,
+           !((size_t) p_doubles & 63));
+    E_ArenaMark_t inner = E_ArenaMark();
+    // bigger than the block backing the arena, so another one is pushed
+    byte* p_bytes = (byte*) E_ArenaAlloc(128 * 1024);
+    *(p_bytes + 128 * 1024 - 1) = 0xff;
+    E_ArenaRelease(inner);
+    // lands right where `p_bytes` would have been, had it fit
+    int* p_more = (int*) E_ArenaAlloc(sizeof(int));
+    printf("Reused after release: %d\n", p_more == (int*) (p_doubles + 8));
+    *p_ints = *p_more = 0;
+    E_ArenaRelease(outer);
+    // the bottom block is kept, and handed out again from the start
+    outer = E_ArenaMark();
+    printf("Bottom block kept after release: %d\n",
+           E_ArenaAlloc(sizeof(int)) == (void*) p_ints);
+    E_ArenaRelease(outer);
+    // nothing should be left behind once the arena is destroyed
+    E_ArenaDestroy();
+    E_Dump();
+}
+
+void TestVerify (void)
+{
+    E_TrackRecent(1);
+    void* p_blocks[8];
+    for (int i = 0; i < 8; ++i)
+        p_blocks[i] = E_Malloc(16 * (i + 1), TestVerify);
+    for (int i = 0; i < 8; i += 2) E_Free(p_blocks[i]);
+    printf("E_VerifyRecent: %d\n", E_VerifyRecent());
+    int error = 0;
+    for (int i = 0; i < 4; ++i) error |= E_VerifyStep(4);
+    printf("E_VerifyStep: %d\n", error);
+    // overrun the last block into the header of the free block after it
+    size_t* p_overrun = (size_t*) ((byte*) p_blocks[7] + 16 * 8);
+    size_t saved = *p_overrun;
+    *p_overrun = 0xdeadbeef;
+    printf("E_VerifyRecent after an overrun: %d\n", E_VerifyRecent());
+    *p_overrun = saved;
+    for (int i = 1; i < 8; i += 2) E_Free(p_blocks[i]);
+    printf("E_VerifyRecent: %d\n", E_VerifyRecent());
+    E_TrackRecent(0);
+}
+
+void TestCompact (void)
+{
+    E_Zone* p_zone = E_ZoneCreate(1, 0);
+    E_Handle* p_handles[120];
+    for (int i = 0; i < 120; ++i)
+    {
+        p_handles[i] = E_ZoneHandleAlloc(p_zone, 8192, TestCompact);
+        E_Memset(E_HandleLock(p_handles[i]), i, 8192);
+        E_HandleUnlock(p_handles[i]);
+    }
+    // leave holes in between, and pin one of the blocks down
+    for (int i = 0; i < 120; i += 2) E_HandleFree(p_handles[i]);
+    byte* p_pinned = (byte*) E_HandleLock(p_handles[61]);
+    printf("E_ZoneLargestFree before compaction: %zuKiB\n",
+           E_ZoneLargestFree(p_zone) >> 10);
+    printf("E_ZoneLargestFree after compaction: %zuKiB\n",
+           E_ZoneCompact(p_zone) >> 10);
+    int intact = E_HandleLock(p_handles[61]) == p_pinned;
+    for (int i = 1; i < 120; i += 2)
+    {
+        byte* ptr = (byte*) E_HandleLock(p_handles[i]);
+        intact &= ptr[0] == i && ptr[8191] == i;
+        E_HandleUnlock(p_handles[i]);
+    }
+    // refused, as long as the block is locked
+    E_HandleFree(p_handles[61]);
+    E_HandleUnlock(p_handles[61]);
+    E_HandleUnlock(p_handles[61]);
+    printf("Moved blocks intact: %d\n", intact);
+    printf("E_ZoneVerify: %d\n", E_ZoneVerify(p_zone));
+    for (int i = 1; i < 120; i += 2) E_HandleFree(p_handles[i]);
+    E_ZoneDestroy(p_zone);
+}
 
 void TestDisjointSet (void)
 {
     // TODO: write tests for Disjoint Sets
 }
 
+static void TestAVLVisit (AVL_Node* p_node, void* p_sum)
+{
+    *((int*) p_sum) += p_node->data;
+}
+
 void TestAVL (void)
 {
     AVL_Tree* p_tree = AVL_InitTree();
@@ -40,6 +272,127 @@ void TestAVL (void)
     AVL_Dump(*p_tree);
     AVL_Destroy(p_tree);
     E_Dump();
+    // ascending keys make for a perfectly balanced tree
+    p_tree = AVL_InitTree();
+    for (int i = 0; i < 1023; ++i) AVL_Push(p_tree, i);
+    printf("AVL_Depth after 1023 ascending pushes: %d\n", AVL_Depth(p_tree));
+    for (int i = 0; i < 1023; i += 2) AVL_Remove(p_tree, i);
+    printf("AVL_Depth after removing the even keys: %d\n", AVL_Depth(p_tree));
+    printf("AVL_Find(100): %p, AVL_Find(101): %d\n",
+           (void*) AVL_Find(p_tree, 100), AVL_Find(p_tree, 101)->data);
+    printf("AVL_LowerBound(100): %d, AVL_UpperBound(101): %d\n",
+           AVL_LowerBound(p_tree, 100)->data,
+           AVL_UpperBound(p_tree, 101)->data);
+    int sum = 0;
+    size_t count = AVL_VisitRange(p_tree, 100, 200, TestAVLVisit, &sum);
+    printf("AVL_VisitRange [100, 200): %zu keys, adding up to %d\n", count,
+           sum);
+    AVL_Destroy(p_tree);
+    int keys[1000];
+    for (int i = 0; i < 1000; ++i) keys[i] = i * 3;
+    p_tree = AVL_BuildSorted(keys, 1000);
+    printf("AVL_Depth after AVL_BuildSorted of 1000 keys: %d\n",
+           AVL_Depth(p_tree));
+    // the bulk-loaded nodes mix with the ones pushed and removed later
+    for (int i = 0; i < 1000; i += 3) AVL_Remove(p_tree, i * 3);
+    for (int i = 0; i < 100; ++i) AVL_Push(p_tree, i * 3 + 1);
+    printf("AVL_VisitRange [0, 300): %zu keys\n",
+           AVL_VisitRange(p_tree, 0, 300, NULL, NULL));
+    AVL_Frozen* p_frozen = AVL_Freeze(p_tree);
+    printf("AVL_FrozenLowerBound(8): %d, AVL_FrozenContains(9): %d, " \
+           "AVL_FrozenContains(12): %d\n", *AVL_FrozenLowerBound(p_frozen, 8),
+           AVL_FrozenContains(p_frozen, 9), AVL_FrozenContains(p_frozen, 12));
+    printf("AVL_FrozenLowerBound(10000): %p\n",
+           (void*) AVL_FrozenLowerBound(p_frozen, 10000));
+    AVL_FrozenDestroy(p_frozen);
+#ifdef AVL_SIZES
+    AVL_TrackSizes(p_tree, 1);
+#endif
+    AVL_Push(p_tree, 299);
+    AVL_Remove(p_tree, 3);
+#ifdef AVL_SIZES
+    printf("AVL_Select(0): %d, AVL_Select(10): %d, AVL_Rank(299): %zu, " \
+           "AVL_Rank(300): %zu\n", AVL_Select(p_tree, 0)->data,
+           AVL_Select(p_tree, 10)->data, AVL_Rank(p_tree, 299),
+           AVL_Rank(p_tree, 300));
+#endif
+    // a batch spread over the tree, on a few threads
+    int batch[2000];
+    for (int i = 0; i < 2000; ++i) batch[i] = (i * 7919) % 4000;
+    AVL_PushBatch(p_tree, batch, 2000, 4);
+    printf("AVL_PushBatch of 2000 keys: AVL_Depth: %d\n", AVL_Depth(p_tree));
+#ifdef AVL_SIZES
+    printf("AVL_Rank(2000): %zu, AVL_Select(1000): %d\n",
+           AVL_Rank(p_tree, 2000), AVL_Select(p_tree, 1000)->data);
+#endif
+    AVL_Destroy(p_tree);
+    // too small a tree to split, built anew along with the batch instead
+    p_tree = AVL_InitTree();
+    AVL_Push(p_tree, 4000);
+    AVL_PushBatch(p_tree, batch, 2000, 4);
+    printf("AVL_PushBatch into 1 key: AVL_Depth: %d, AVL_VisitRange: %zu " \
+           "keys, AVL_Find(4000): %d\n", AVL_Depth(p_tree),
+           AVL_VisitRange(p_tree, 0, 4001, NULL, NULL),
+           AVL_Find(p_tree, 4000) != NULL);
+    AVL_Destroy(p_tree);
+    static const char* orders[] = { "in-order", "pre-order", "post-order" };
+    p_tree = AVL_BuildSorted(keys, 7);
+    for (int order = AVL_INORDER; order <= AVL_POSTORDER; ++order)
+    {
+        AVL_Iter iter;
+        printf("AVL_IterNext, %s:", orders[order]);
+        for (AVL_Node* p_node = AVL_IterBegin(&iter, p_tree, order); p_node;
+             p_node = AVL_IterNext(&iter))
+            printf(" %d", p_node->data);
+        printf("\n");
+    }
+    AVL_Destroy(p_tree);
+}
+
+typedef struct {
+    long long id;
+    AVLM_Node byname; // keyed by `name`
+    const char* name;
+} TestRecord;
+
+void TestAVLMap (void)
+{
+    /* integer keys, with the values held by the map */
+    AVLM_Map* p_map = AVLM_Init(NULL);
+    static const char* digits[] = { "zero", "one", "two", "three", "four" };
+    for (int i = 0; i < 5; ++i)
+        AVLM_Put(p_map, AVLM_INT(1LL << (i + 32)), (void*) digits[i]);
+    AVLM_Put(p_map, AVLM_INT(1LL << 34), "TWO");
+    AVLM_Remove(p_map, AVLM_INT(1LL << 33));
+    printf("AVLM_Get(2^34): %s, AVLM_Get(2^33): %p, size: %zu\n",
+           (const char*) AVLM_Get(p_map, AVLM_INT(1LL << 34)),
+           AVLM_Get(p_map, AVLM_INT(1LL << 33)), p_map->size);
+    AVLM_Destroy(p_map);
+    /* string keys, with the nodes embedded in the records */
+    TestRecord records[] = { { .id = 3, .name = "carol" },
+                             { .id = 1, .name = "alice" },
+                             { .id = 2, .name = "bob" } };
+    p_map = AVLM_Init(AVLM_CompareStrings);
+    for (int i = 0; i < 3; ++i)
+    {
+        records[i].byname.key = AVLM_PTR(records[i].name);
+        AVLM_Insert(p_map, &records[i].byname);
+    }
+    // a node of the caller can't be linked into a map that owns its nodes
+    AVLM_Map* p_owning = AVLM_Init(AVLM_CompareStrings);
+    AVLM_Put(p_owning, AVLM_PTR("dave"), NULL);
+    printf("AVLM_Insert into an owning map: %d\n",
+           AVLM_Insert(p_owning, &records[0].byname) == &records[0].byname);
+    AVLM_Destroy(p_owning);
+    AVLM_Node* p_node = AVLM_LowerBound(p_map, AVLM_PTR("b"));
+    printf("AVLM_LowerBound(\"b\"): %s, id %lld\n",
+           AVLM_ENTRY(p_node, TestRecord, byname)->name,
+           AVLM_ENTRY(p_node, TestRecord, byname)->id);
+    AVLM_Erase(p_map, AVLM_PTR("bob"));
+    p_node = AVLM_LowerBound(p_map, AVLM_PTR("b"));
+    printf("AVLM_LowerBound(\"b\") after erasing bob: %s\n",
+           AVLM_ENTRY(p_node, TestRecord, byname)->name);
+    AVLM_Destroy(p_map);
 }
 
 void TestMatrixInversion (void)
@@ -62,6 +415,29 @@ void TestMatrixInversion (void)
     E_Free(inverted);
     E_Free(testforidentity);
     E_Dump();
+
+    double singular[] = { 1, 2,
+                          2, 4 };
+    printf("Singular matrix inverted: %d\n", M_Invert(singular, 2) != NULL);
+
+    /* test the inner product with both vectors at every offset, so it goes
+     * through the aligned and unaligned vector paths and the scalar tails
+     */
+    double vector0[40], vector1[40];
+    for (int i = 0; i < 40; ++i) { vector0[i] = i; vector1[i] = 40 - i; }
+    int dotfailed = 0;
+    for (int offset0 = 0; offset0 < 4; ++offset0)
+    {
+        for (int offset1 = 0; offset1 < 4; ++offset1)
+        {
+            double expected = 0;
+            for (int d = 0; d < 35; ++d)
+                expected += vector0[offset0 + d] * vector1[offset1 + d];
+            dotfailed |= M_Dot(vector0 + offset0, vector1 + offset1, 35) !=
+                         expected;
+        }
+    }
+    printf("M_Dot failed: %d\n", dotfailed);
 }
 
 void TestMatrixRREF (void)
@@ -216,6 +592,23 @@ void TestHeap ()
     H_Heapify(raw, heap, size);
     H_PrintHeap(heap, size);
     while (size > 0) printf("Popped %d\n", H_HeapPop(heap, &size).data);
+    size = 5;
+    H_HeapifyInPlace(raw, size);
+    while (size > 0) printf("Popped %d\n", H_HeapPop(raw, &size).data);
+    // more nodes than it starts with room for, to make the queue grow
+    H_Queue* p_queue = H_QueueInit(0);
+    int handles[20];
+    for (int i = 0; i < 20; ++i) handles[i] = H_Push(p_queue, i, i % 7);
+    H_UpdateKey(p_queue, handles[3], 10);
+    H_UpdateKey(p_queue, handles[6], -1);
+    printf("H_Peek: %d, size: %d, capacity: %d\n", H_Peek(p_queue)->data,
+           p_queue->size, p_queue->capacity);
+    while (p_queue->size > 15) printf("H_Pop: %d\n", H_Pop(p_queue).data);
+    H_UpdateKey(p_queue, handles[3], 0);
+    printf("H_Push after popping reuses handle %d\n",
+           H_Push(p_queue, 20, 3));
+    while (p_queue->size) printf("H_Pop: %d\n", H_Pop(p_queue).data);
+    H_QueueDestroy(p_queue);
 }
 
 void TestDynlist ()
@@ -275,10 +668,76 @@ void TestSBuffer ()
     E_Dump();
 }
 
+typedef struct {
+    const char* name;
+    void (*run) (void);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    { "alloc-threads", B_AllocThreads },
+    { "aligned-mult", B_AlignedMult },
+    { "memcpy", B_Memcpy },
+    { "slab-churn", B_SlabChurn },
+    { "fragmentation", B_Fragmentation },
+    { "avl-push", B_AVLPush },
+    { "avl-batch", B_AVLPushBatch },
+    { "avl-iter", B_AVLIter },
+    { "heapify", B_Heapify },
+    { "heap-queue", B_HeapQueue },
+    { "avl-build", B_AVLBuild },
+    { "avl-frozen", B_AVLFrozen },
+    { "avl-map", B_AVLMap },
+};
+
+/* runs the benchmarks named in `argv`, or all of them if none is named */
+int Bench (int argc, const char** argv)
+{
+    int numbenchmarks = sizeof(benchmarks) / sizeof(Benchmark), error = 0;
+    for (int i = 0; i < numbenchmarks; ++i)
+    {
+        int selected = !argc;
+        for (int a = 0; a < argc && !selected; ++a)
+            selected = !strcmp(argv[a], benchmarks[i].name);
+        if (!selected) continue;
+        printf("[%s]\n", benchmarks[i].name);
+        benchmarks[i].run();
+        printf("\n");
+    }
+    for (int a = 0; a < argc; ++a)
+    {
+        int found = 0;
+        for (int i = 0; i < numbenchmarks && !found; ++i)
+            found = !strcmp(argv[a], benchmarks[i].name);
+        if (!found)
+        {
+            printf("Bench: Unknown benchmark \"%s\".\n", argv[a]);
+            error = 1;
+        }
+    }
+    return error;
+}
+
 int main (int argc, const char** argv)
 {
+    // `algs bench [name...]` runs the benchmarks instead of the tests
+    if (argc > 1 && !strcmp(argv[1], "bench")) return Bench(argc - 2, argv + 2);
+    // `algs replay <file>` replays a trace recorded by `algs record <file>`,
+    // which runs the tests while tracing the allocator
+    if (argc > 2 && !strcmp(argv[1], "replay")) return B_Replay(argv[2]);
+    int record = argc > 2 && !strcmp(argv[1], "record");
+    if (record && E_TraceStart(argv[2])) return 1;
     E_Init(1);
+    TestZone();
+    TestAlignedAlloc();
+    TestMemcpy();
+    TestSlab();
+    TestProfile();
+    TestTags();
+    TestArena();
+    TestVerify();
+    TestCompact();
     TestAVL();
+    TestAVLMap();
     TestMatrixInversion();
     TestMatrixRREF();
     TestLookAt();
@@ -289,10 +748,12 @@ int main (int argc, const char** argv)
     TestSubsets();
     TestDynlist();
     TestSBuffer();
+    TestHeap();
+    E_ArenaDestroy();
     E_Destroy();
     TestSubstrings();
-    TestHeap();
     TestDynProg();
     TestSort();
+    if (record) E_TraceStop();
     return 0;
 }
@@ -11,12 +11,16 @@
 #include <stdio.h>
 
 #include "e_malloc.h"
+#include "e_arena.h"
 #include "q_queue.h"
 #include "z_zigzagtree.h" // NOTE: needed only in `Q_Print`
 
-static qnode_t* Q_InitNode (void* data)
+static qnode_t* Q_InitNode (queue_t* queue, void* data)
 {
-    qnode_t* qnode = (qnode_t*) E_Malloc(sizeof(qnode_t), Q_InitNode);
+    qnode_t* qnode;
+    if (queue->slab) qnode = (qnode_t*) E_SlabAlloc(queue->slab);
+    else if (queue->scratch) qnode = (qnode_t*) E_ArenaAlloc(sizeof(qnode_t));
+    else qnode = (qnode_t*) E_Malloc(sizeof(qnode_t), Q_InitNode);
     qnode->data = data;
     qnode->next = NULL;
     return qnode;
@@ -27,12 +31,48 @@ queue_t* Q_Init (void)
     queue_t* queue = (queue_t*) E_Malloc(sizeof(queue_t), Q_Init);
     queue->head = NULL;
     queue->tail = NULL;
+    queue->slab = NULL;
+    queue->scratch = 0;
     return queue;
 }
 
+/* allocates the nodes of the queue from `slab` from now on, which may be
+ * shared with other queues; can only be changed while the queue is empty
+ */
+void Q_UseSlab (queue_t* queue, E_Slab* slab)
+{
+    if (!Q_IsEmpty(queue))
+    {
+        printf("Q_UseSlab: Queue is not empty.\n");
+        return;
+    }
+    if (slab && E_SlabObjSize(slab) < sizeof(qnode_t))
+    {
+        printf("Q_UseSlab: Slab objects too small.\n");
+        return;
+    }
+    queue->slab = slab;
+    queue->scratch = 0;
+}
+
+/* allocates the nodes of the queue from the scratch arena from now on–the
+ * popped nodes are not freed, but dropped along with the arena once the mark
+ * taken by the caller is released
+ */
+void Q_UseArena (queue_t* queue)
+{
+    if (!Q_IsEmpty(queue))
+    {
+        printf("Q_UseArena: Queue is not empty.\n");
+        return;
+    }
+    queue->slab = NULL;
+    queue->scratch = 1;
+}
+
 void Q_Push (queue_t* queue, void* data)
 {
-    qnode_t* qnode = Q_InitNode(data);
+    qnode_t* qnode = Q_InitNode(queue, data);
     if (Q_IsEmpty(queue))
     {
         queue->head = qnode;
@@ -55,7 +95,8 @@ void* Q_Pop (queue_t* queue)
     }
     else
         queue->head = queue->head->next;
-    E_Free(popped);
+    if (queue->slab) E_SlabFree(queue->slab, popped);
+    else if (!queue->scratch) E_Free(popped);
     return data;
 }
 
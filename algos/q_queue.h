@@ -6,13 +6,21 @@
  *
  *  SYNOPSIS:
  *      A module that helps in keeping a list of elements in a queue structure.
+ *
+ *      The nodes can be allocated from a slab instead of `E_Malloc`, see
+ *      `Q_UseSlab`, or from the scratch arena for a throwaway queue, see
+ *      `Q_UseArena`.
  */
 
 #ifndef queue_h
 
+#include "e_slab.h"
+
 #define queue_h
 #define q_queue_h_qnode_t qnode_t
 #define q_queue_h_Q_Init Q_Init
+#define q_queue_h_Q_UseSlab Q_UseSlab
+#define q_queue_h_Q_UseArena Q_UseArena
 #define q_queue_h_Q_Push Q_Push
 #define q_queue_h_Q_Pop Q_Pop
 #define q_queue_h_Q_IsEmpty Q_IsEmpty
@@ -28,9 +36,13 @@ typedef struct qnode qnode_t;
 
 typedef struct {
     qnode_t *head, *tail;
+    E_Slab* slab; // where the nodes come from, `E_Malloc` if NULL
+    int scratch; // the nodes come from the scratch arena instead
 } queue_t;
 
 queue_t* Q_Init (void);
+void Q_UseSlab (queue_t* queue, E_Slab* slab);
+void Q_UseArena (queue_t* queue);
 void Q_Push (queue_t* queue, void* data);
 void* Q_Pop (queue_t* queue);
 int Q_IsEmpty (queue_t* queue);
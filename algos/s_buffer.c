@@ -32,9 +32,12 @@
 #define DEP(n) (MAX((n)->prev ? ((n)->prev->depth + 1) : 0, \
                     (n)->next ? ((n)->next->depth + 1) : 0))
 
-static span_t* SB_Span (int x0, int x1, byte id)
+static span_t* SB_Span (sbuffer_t* sbuffer, int x0, int x1, byte id)
 {
-    span_t* span = (span_t*) E_Malloc(sizeof(span_t), SB_Span);
+    span_t* span;
+
+    if (sbuffer->slab) span = (span_t*) E_SlabAlloc(sbuffer->slab);
+    else span = (span_t*) E_Malloc(sizeof(span_t), SB_Span);
 
     span->prev = 0;
     span->next = 0;
@@ -53,10 +56,31 @@ sbuffer_t* SB_Init (int size, size_t max_depth)
     sbuffer->root = 0;
     sbuffer->size = size;
     sbuffer->max_depth = max_depth;
+    sbuffer->slab = 0;
 
     return sbuffer;
 }
 
+/* allocates the spans of the S-Buffer from `slab` from now on, which may be
+ * shared with other S-Buffers; can only be changed while the S-Buffer is empty
+ */
+void SB_UseSlab (sbuffer_t* sbuffer, E_Slab* slab)
+{
+    if (sbuffer->root)
+    {
+        printf("SB_UseSlab: S-Buffer is not empty.\n");
+        return;
+    }
+
+    if (slab && E_SlabObjSize(slab) < sizeof(span_t))
+    {
+        printf("SB_UseSlab: Slab objects too small.\n");
+        return;
+    }
+
+    sbuffer->slab = slab;
+}
+
 typedef struct {
     span_t* span;
     int     left, right;
@@ -80,7 +104,7 @@ int SB_Push (sbuffer_t* sbuffer, int x0, int x1, byte id)
         if (clipped_size > 0)
         {
             const int new_x0 = x0 + clipleft, new_x1 = new_x0 + clipped_size;
-            sbuffer->root = SB_Span(new_x0, new_x1, id);
+            sbuffer->root = SB_Span(sbuffer, new_x0, new_x1, id);
 
             return 0;
         }
@@ -141,7 +165,7 @@ int SB_Push (sbuffer_t* sbuffer, int x0, int x1, byte id)
         if (clipped_size > 0)
         {
             const int new_x0 = x + clipleft, new_x1 = new_x0 + clipped_size;
-            curr = SB_Span(new_x0, new_x1, id);
+            curr = SB_Span(sbuffer, new_x0, new_x1, id);
             if (x < parent->x0) parent->prev = curr;
             else parent->next = curr;
             pushed = 0xff;
@@ -435,7 +459,8 @@ void SB_Destroy (sbuffer_t* sbuffer)
                 else grandparent->next = 0;
             }
 
-            E_Free(parent);
+            if (sbuffer->slab) E_SlabFree(sbuffer->slab, parent);
+            else E_Free(parent);
             curr = grandparent; // continue freeing from the grandparent
         }
     }
@@ -10,7 +10,8 @@
  *      removal problem in software rendering.
  *
  *      The implementation uses a binary tree instead of a linked list to cut
- *      down on the search time.
+ *      down on the search time. The spans can be allocated from a slab instead
+ *      of `E_Malloc`, see `SB_UseSlab`.
  *
  *      Original FAQ by Paul Nettle:
  *      https://www.gamedev.net/articles/programming/graphics/s-buffer-faq-r668/
@@ -19,11 +20,13 @@
 #ifndef s_buffer_h
 
 #include "t_typedef.h"
+#include "e_slab.h"
 
 #define s_buffer_h
 #define s_buffer_h_span_t span_t
 #define s_buffer_h_sbuffer_t sbuffer_t
 #define s_buffer_h_SB_Init SB_Init
+#define s_buffer_h_SB_UseSlab SB_UseSlab
 #define s_buffer_h_SB_Push SB_Push
 #define s_buffer_h_SB_Dump SB_Dump
 #define s_buffer_h_SB_Print SB_Print
@@ -40,9 +43,11 @@ typedef struct {
     span_t* root;
     int     size;
     size_t  max_depth;
+    E_Slab* slab; // where the spans come from, `E_Malloc` if NULL
 } sbuffer_t;
 
 sbuffer_t* SB_Init (int size, size_t max_depth);
+void SB_UseSlab (sbuffer_t* sbuffer, E_Slab* slab);
 int SB_Push (sbuffer_t* sbuffer, int x0, int x1, byte id);
 void SB_Dump (sbuffer_t* sbuffer);
 void SB_Print (sbuffer_t* sbuffer);
@@ -11,12 +11,15 @@
 #include <stdio.h>
 
 #include "e_malloc.h"
+#include "e_arena.h"
 #include "z_zigzagtree.h"
 #include "q_queue.h"
 
-static node_t* Z_InitNode (int data)
+static node_t* Z_InitNode (tree_t* tree, int data)
 {
-    node_t* node = (node_t*) E_Malloc(sizeof(node_t), Z_InitNode);
+    node_t* node;
+    if (tree->slab) node = (node_t*) E_SlabAlloc(tree->slab);
+    else node = (node_t*) E_Malloc(sizeof(node_t), Z_InitNode);
     node->data = data;
     node->left = NULL;
     node->right = NULL;
@@ -27,18 +30,40 @@ tree_t* Z_Init (void)
 {
     tree_t* tree = (tree_t*) E_Malloc(sizeof(tree_t), Z_Init);
     tree->root = NULL;
+    tree->slab = NULL;
     return tree;
 }
 
+/* allocates the nodes of the tree from `slab` from now on, which may be shared
+ * with other trees; can only be changed while the tree is empty
+ */
+void Z_UseSlab (tree_t* tree, E_Slab* slab)
+{
+    if (!Z_IsEmpty(tree))
+    {
+        printf("Z_UseSlab: Tree is not empty.\n");
+        return;
+    }
+    if (slab && E_SlabObjSize(slab) < sizeof(node_t))
+    {
+        printf("Z_UseSlab: Slab objects too small.\n");
+        return;
+    }
+    tree->slab = slab;
+}
+
 void Z_Insert (tree_t* tree, int data)
 {
-    node_t* node = Z_InitNode(data);
+    node_t* node = Z_InitNode(tree, data);
     if (Z_IsEmpty(tree))
     {
         tree->root = node;
         return;
     }
+    // the queue is thrown away once the spot for the node is found
+    E_ArenaMark_t mark = E_ArenaMark();
     queue_t* queue = Q_Init();
+    Q_UseArena(queue);
     Q_Push(queue, tree->root);
     while (!Q_IsEmpty(queue))
     {
@@ -57,13 +82,16 @@ void Z_Insert (tree_t* tree, int data)
         Q_Push(queue, current->right);
     }
     Q_Destroy(queue);
+    E_ArenaRelease(mark);
 }
 
 int Z_Size (tree_t* tree)
 {
     int size = 0;
     if (Z_IsEmpty(tree)) return size;
+    E_ArenaMark_t mark = E_ArenaMark();
     queue_t* queue = Q_Init();
+    Q_UseArena(queue);
     Q_Push(queue, tree->root);
     while (!Q_IsEmpty(queue))
     {
@@ -73,6 +101,7 @@ int Z_Size (tree_t* tree)
         ++size;
     }
     Q_Destroy(queue);
+    E_ArenaRelease(mark);
     return size;
 }
 
@@ -97,7 +126,8 @@ void Z_Destroy (tree_t* tree)
         if (current->right) Q_Push(queue, current->right);
         current->left = NULL;
         current->right = NULL;
-        E_Free(current);
+        if (tree->slab) E_SlabFree(tree->slab, current);
+        else E_Free(current);
     }
     tree->root = NULL;
     E_Free(tree);
@@ -144,10 +174,10 @@ void Z_PrintZigZag (tree_t* tree)
     }
     int index = 0;
     int size = Z_Size(tree), halfsize = size >> 1;
-    node_t** rtl = (node_t**) E_Malloc(sizeof(node_t*) * halfsize,
-                                       Z_PrintZigZag);
-    node_t** ltr = (node_t**) E_Malloc(sizeof(node_t*) * (size - halfsize),
-                                       Z_PrintZigZag);
+    // both stacks are thrown away at once when we're done
+    E_ArenaMark_t mark = E_ArenaMark();
+    node_t** rtl = (node_t**) E_ArenaAlloc(sizeof(node_t*) * halfsize);
+    node_t** ltr = (node_t**) E_ArenaAlloc(sizeof(node_t*) * (size - halfsize));
     int nextrtl = 0, nextltr = 0;
     *ltr = tree->root;
     ++nextltr;
@@ -188,6 +218,5 @@ void Z_PrintZigZag (tree_t* tree)
             ++index;
         }
     }
-    E_Free(rtl);
-    E_Free(ltr);
+    E_ArenaRelease(mark);
 }
@@ -6,14 +6,20 @@
  *
  *  SYNOPSIS:
  *      A module that helps print a binary tree in a "zig-zag" pattern.
+ *
+ *      The nodes can be allocated from a slab instead of `E_Malloc`, see
+ *      `Z_UseSlab`.
  */
 
 #ifndef zigzag_tree_h
 
+#include "e_slab.h"
+
 #define zigzag_tree_h
 #define z_zigzagtree_h_node_t node_t
 #define z_zigzagtree_h_tree_t tree_t
 #define z_zigzagtree_h_Z_Init Z_Init
+#define z_zigzagtree_h_Z_UseSlab Z_UseSlab
 #define z_zigzagtree_h_Z_Insert Z_Insert
 #define z_zigzagtree_h_Z_Size Z_Size
 #define z_zigzagtree_h_Z_IsEmpty Z_IsEmpty
@@ -30,9 +36,11 @@ typedef struct node node_t;
 
 typedef struct {
     node_t* root;
+    E_Slab* slab; // where the nodes come from, `E_Malloc` if NULL
 } tree_t;
 
 tree_t* Z_Init (void);
+void Z_UseSlab (tree_t* tree, E_Slab* slab);
 void Z_Insert (tree_t* tree, int data);
 int Z_Size (tree_t* tree);
 int Z_IsEmpty (tree_t* tree);